@@ -4,6 +4,10 @@
 #include "Exceptions.h"
 #include "HashStruct.h"
 
+/* Live and peak A* Node counts across every search */
+unsigned long AStarNode::live_count = 0;
+unsigned long AStarNode::peak_count = 0;
+
 /*
 * Default constructor
 */
@@ -14,8 +18,9 @@ AStarNode::AStarNode()
 	pos = *temp;
 	delete temp;
 
-	/* No parent for this node */
-	parents = 0;
+	/* No parent or child for this node */
+	parents.store(0, std::memory_order_relaxed);
+	children = 0;
 
 	/* 
 	* Default cost is -1 so the user can confirm this node has
@@ -25,6 +30,8 @@ AStarNode::AStarNode()
 
 	/* Not marked for deletion by default */
 	del_mark = false;
+
+	count_node();
 }
 
 /*
@@ -41,17 +48,26 @@ AStarNode::AStarNode(Position* p_pos, AStarNode* p_parent, double p_cost)
 	/* Set the cost of the node */
 	cost = p_cost;
 
-	/* Add the parent node */
+	/* Add the parent node, and this node as its child */
 	if (p_parent != NULL)
 	{
-		parents =
-			HashStruct::hash_coord_comp(p_parent->get_pos()->get_coord(), p_pos->get_coord());
+		parents.store(
+			HashStruct::hash_coord_comp(p_parent->get_pos()->get_coord(), p_pos->get_coord()),
+			std::memory_order_relaxed
+			);
+		p_parent->children |=
+			HashStruct::hash_coord_comp(p_pos->get_coord(), p_parent->get_pos()->get_coord());
 	}
 	else
-		parents = 0;
+		parents.store(0, std::memory_order_relaxed);
+
+	/* Not expanded yet */
+	children = 0;
 	
 	/* Not marked for deletion by default */
 	del_mark = false;
+
+	count_node();
 }
 
 /*
@@ -67,11 +83,14 @@ AStarNode::AStarNode(AStarNode* a_star_node)
 	/* Set the cost of the node */
 	cost = a_star_node->get_cost();
 
-	/* Get parameter A* Node's parents */
-	parents = a_star_node->get_parents();
+	/* Get parameter A* Node's parents and children */
+	parents.store(a_star_node->get_parents(), std::memory_order_relaxed);
+	children = a_star_node->get_children();
 
 	/* Not marked for deletion by default */
 	del_mark = a_star_node->del_mark;
+
+	count_node();
 }
 
 /*
@@ -80,13 +99,15 @@ AStarNode::AStarNode(AStarNode* a_star_node)
 */
 Coord AStarNode::get_parent()
 { 
+	unsigned short bitmap = get_parents();
+
 	/* Throw an error if no parent is found. */
-	if (parents == 0)
+	if (bitmap == 0)
 		throw TerminalException("No parent found for a node.");
 
 	/* Find the first bit that is a 1 in the parents bitmap */
 	unsigned short comp = 1;
-	while ((comp & parents) == 0)
+	while ((comp & bitmap) == 0)
 		comp = comp << 1;
 
 	/* Convert that bit back to a coordinate */
@@ -104,11 +125,13 @@ void AStarNode::add_parent(AStarNode* parent)
 		HashStruct::hash_coord_comp(parent->get_pos()->get_coord(), pos.get_coord());
 
 	/* Make sure the parent is not already in the bitmap */
-	if ((parents & hash) != 0)
+	unsigned short bitmap = get_parents();
+	if ((bitmap & hash) != 0)
 		throw TerminalException("Added pre-existing parent to parent list of an A* Node");
 
-	/* Update the parents bitmap */
-	parents |= hash;
+	/* Update the parents bitmap, and the children bitmap of the parent */
+	parents.store(bitmap | hash, std::memory_order_relaxed);
+	parent->children |= HashStruct::hash_coord_comp(pos.get_coord(), parent->get_pos()->get_coord());
 }
 
 /*
@@ -123,13 +146,42 @@ unsigned short AStarNode::del_parent(Coord* parent)
 		HashStruct::hash_coord_comp(parent, pos.get_coord());
 
 	/* Make sure the node exists */
-	if ((hash & parents) == 0)
+	unsigned short bitmap = get_parents();
+	if ((hash & bitmap) == 0)
 		throw TerminalException("Tried to decrement a non-existant parent node.");
 
 	/* Remove the parent from the list */
-	parents &= ~hash;
+	bitmap &= ~hash;
+	parents.store(bitmap, std::memory_order_relaxed);
+
+	return bitmap;
+}
 
-	return parents;
+/*
+* Remove a parent while other threads may remove other parents of this node.
+* Exactly one thread sees the bitmap become empty.
+* @param parent: The coordinate of the parent node to remove
+* @return the parent bitmap left after this removal, the parent bit set if the
+* parent was not in the bitmap
+*/
+unsigned short AStarNode::atomic_del_parent(Coord* parent)
+{
+	unsigned short hash = HashStruct::hash_coord_comp(parent, pos.get_coord());
+	unsigned short bitmap = parents.fetch_and(~hash, std::memory_order_relaxed);
+
+	/* A missing parent leaves its bit set so the caller does not take it for the last one */
+	if ((bitmap & hash) == 0)
+		return bitmap | hash;
+	return bitmap & ~hash;
+}
+
+/*
+* Remove a child from the children bitmap, if it is in it
+* @param child: The coordinate of the child node to remove
+*/
+void AStarNode::del_child(Coord* child)
+{
+	children &= ~HashStruct::hash_coord_comp(child, pos.get_coord());
 }
 
 /*
@@ -211,7 +263,7 @@ void AStarNode::print_parents()
 	for (int i = 0; i < NUM_PARENTS; i++)
 	{
 		Coord print_coord = HashStruct::hash_to_coord(bit_trav, pos.get_coord());
-		if ((parents & bit_trav) != 0)
+		if ((get_parents() & bit_trav) != 0)
 			std::cout << print_coord << std::endl;
 		bit_trav = bit_trav << 1;
 	}
@@ -224,19 +276,33 @@ void AStarNode::print_parents()
 */
 bool AStarNode::check_parent(Coord* parent)
 {
-	/* Get the hash for the parent */
-	unsigned short hash = HashStruct::hash_coord_comp(parent, pos.get_coord());
-
 	/* No parents in bitmap */
 	if (parent == NULL)
-	{
-		if (hash != 0)
-			return false;
-		return true;
-	}
+		return get_parents() == 0;
+
+	/* Get the hash for the parent */
+	unsigned short hash = HashStruct::hash_coord_comp(parent, pos.get_coord());
 
 	/* Compare the hash to the list of parents */
-	if ((hash & parents) == 0)
+	if ((hash & get_parents()) == 0)
 		return false;
 	return true;
+}
+
+/*
+* Count an allocated node and update the high-water mark
+*/
+void AStarNode::count_node()
+{
+	live_count++;
+	if (live_count > peak_count)
+		peak_count = live_count;
+}
+
+/*
+* Destructor
+*/
+AStarNode::~AStarNode()
+{
+	live_count--;
 }
\ No newline at end of file
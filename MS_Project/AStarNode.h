@@ -1,6 +1,8 @@
 #ifndef ASTARNODE_H
 #define ASTARNODE_H
 
+#include <atomic>
+
 #include "Coordinates.h"
 
 class Position;
@@ -25,29 +27,54 @@ public:
 	Position* get_pos() { return &pos; };
 	double get_cost() const { return cost; };
 	Coord get_parent();
-	unsigned short get_parents() { return parents; };
+	unsigned short get_parents() const { return parents.load(std::memory_order_relaxed); };
 	bool get_del_mark() const { return del_mark; };
-	unsigned short get_parent_bitmap() { return parents; };
+	unsigned short get_parent_bitmap() const { return parents.load(std::memory_order_relaxed); };
+	unsigned short get_children() const { return children; };
 
 	/* Add a parent if it is not already in the parents table */
 	void add_parent(AStarNode* parent);
 	/* Remove a parent node (decrement the counter) */
 	unsigned short del_parent(Coord* parent);
+	/* Remove a parent while other threads may remove other parents of this node */
+	unsigned short atomic_del_parent(Coord* parent);
+	/* Remove a child from the children bitmap */
+	void del_child(Coord* child);
 	/* Mark for deletion */
 	void mark_for_deletion() { del_mark = true; };
 	/* Print parents */
 	void print_parents();
 	/* Check if a parent is in the list of parents */
 	bool check_parent(Coord* parent);
+
+	/* Number of A* Nodes currently allocated and the most allocated at once */
+	static unsigned long get_live_count() { return live_count; };
+	static unsigned long get_peak_count() { return peak_count; };
+	/* Restart the high-water mark from the number of nodes currently allocated */
+	static void reset_peak_count() { peak_count = live_count; };
+
+	/* Destructor */
+	~AStarNode();
 private:
-	/* Bitmap for the parents of this node */
-	unsigned short parents;
+	/*
+	* Bitmap for the parents of this node. Atomic so parallel descendant removal can
+	* drop parents concurrently, every other access is a relaxed load or store.
+	*/
+	std::atomic<unsigned short> parents;
+	/* Bitmap for the children of this node, set whenever it becomes a parent */
+	unsigned short children;
 	/* Position (coordinates and depth) of the node*/
 	Position pos;
 	/* Cost of this node */
 	double cost;
 	/* Mark this node for deletion if it is in the OPEN list */
 	bool del_mark;
+
+	/* Count an allocated node and update the high-water mark */
+	static void count_node();
+	/* Live and peak A* Node counts across every search */
+	static unsigned long live_count;
+	static unsigned long peak_count;
 };
 
 #endif
\ No newline at end of file
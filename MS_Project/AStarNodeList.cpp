@@ -64,7 +64,7 @@ AStarNode* AStarNodeList::check_duplicate(Position* pos, Coord* parent_coord)
 	AStarNode* found = list->find(pos);
 
 	/* Check the node for the parent */
-	if (found->check_parent(parent_coord) == false)
+	if (found == NULL || found->check_parent(parent_coord) == false)
 		return NULL;
 	return found;
 }
@@ -193,6 +193,14 @@ void AStarNodeList::node_copy(AStarNodeList* copy_list)
 	copy_list->get_list()->node_copy(list);
 }
 
+/*
+* Delete every node in the list and clear it
+*/
+void AStarNodeList::delete_nodes()
+{
+	list->delete_nodes();
+}
+
 /*
 * Place all elements in the list into a heap 
 * @param heap: The heap to place each element from this list into
@@ -39,6 +39,8 @@ public:
  	*/
 	void remove_hash(AStarNode* node);
 	void remove_hash(Position* pos);
+	/* Delete every node in the list and clear it */
+	void delete_nodes();
 	/* Place all elements in the list into a heap */
 	void heap_place(std::priority_queue<AStarNode*, std::vector<AStarNode*>, std::greater<AStarNode> >* heap);
 	/* Search the map as a linked list for a specific Position */
@@ -164,6 +164,16 @@ AStarNode* AStarNodeMultiMap::search_node(Position* pos)
 	return NULL;
 }
 
+/*
+* Delete every node in the map and clear it, the buckets are kept for reuse
+*/
+void AStarNodeMultiMap::delete_nodes()
+{
+	for (auto it = map.begin(); it != map.end(); ++it)
+		delete it->second;
+	map.clear();
+}
+
 /* 
 * Destructor 
 */
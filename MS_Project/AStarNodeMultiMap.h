@@ -21,6 +21,8 @@ public:
 	bool erase(Position* pos);
 	/* Clear the map */
 	void clear() { map.clear(); };
+	/* Delete every node in the map and clear it */
+	void delete_nodes();
 	/* Copy the map's contents into another map */
 	void node_copy(AStarNodeMultiMap* copy_map);
 	/* Place all elements in the map into a heap */
@@ -1,4 +1,6 @@
 #include <math.h>
+#include <climits>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 
@@ -7,12 +9,22 @@
 #include "Coordinates.h"
 #include "World.h"
 #include "AStarNodeList.h"
+#include "AStarNodeMultiMap.h"
 #include "Exceptions.h"
 #include "HashStruct.h"
-
-#ifndef CBS_CLASSIC
+#include "FocalSearch.h"
+#include "SIPPSearch.h"
+#include "CancelToken.h"
+#include "SolverOptions.h"
 #include "PathClearAStar.h"
-#endif
+#include "DescendantRemoval.h"
+#include "LPAStarSearch.h"
+
+/* Repair decisions since the last reset */
+unsigned long Agent::repair_count = 0;
+unsigned long Agent::restart_count = 0;
+/* States expanded since the last reset */
+unsigned long Agent::expansion_count = 0;
 
 /* 
 * Initialize the agent search and place the root on the OPEN list 
@@ -20,72 +32,302 @@
 * @param p_goal: The goal coordinate of the A* search
 * @param p_world: Pointer to the world this search will navigate
 * @param p_name: The agent's name
-* @param start_time: The start time of the CBS Tree search used 
-* for early termination time limits
+* @param p_cancel_token: Deadline and cancellation flag of the CBS Tree search,
+* NULL if the search runs to completion
+* @param p_options: Configuration of the searches, NULL for the defaults of Macros.h
 */
-#ifdef TIME_LIMIT
 Agent::Agent(
 	Coord* p_start, Coord* p_goal, World* p_world,
-	std::string p_name, std::time_t p_start_time
+	std::string p_name, CancelToken* p_cancel_token, const SolverOptions* p_options
 	)
-#else
-Agent::Agent(Coord* p_start, Coord* p_goal, World* p_world, std::string p_name)
-#endif
 {
+	/* Deadline and cancellation flag of the CBS Tree search */
+	cancel_token = p_cancel_token;
+	options = p_options != NULL ? p_options : SolverOptions::get_defaults();
+
 	/* Get the goal coordinate of the A* Search */
 	goal = new Coord(p_goal);
 
 	/* No goal node is found initially */
 	goal_node = NULL;
+	evicted = false;
+	lower_bound = -1;
+	status = SEARCH_RUNNING;
 
 	/* Store the start coord */
 	start_coord = new Coord(p_start);
 
-	/* Initialize lists and hash tables */
-	open_list = std::priority_queue<AStarNode*, std::vector<AStarNode*>, std::greater<AStarNode> >();
-	open_list_hash_table = new AStarNodeList();
-	closed_list = new AStarNodeList();
-	constraints = std::unordered_map<unsigned int, Position>();
-
-	/* Place the root into the OPEN list */
-	Position start_pos = Position(p_start, 0);
-	AStarNode* start_node = new AStarNode(&start_pos, NULL, calc_cost(&start_pos));
-	open_list.emplace(start_node);
-	open_list_hash_table->add_node(start_node);
-
 	/* Set the world to navigate */
 	world = p_world;
 
-	/* No new constraint */
-	path_clear = NULL;
+	/* Initialize lists and hash tables and place the root into the OPEN list */
+	constraints = std::unordered_map<unsigned int, Position>();
+	constraint_hash = 0;
+	horizon = 0;
+	landmarks = std::vector<Position>();
+	landmark_depth = 0;
+	length_depth = 0;
+	lpa_star = NULL;
+#ifdef SIPP_SEARCH
+	/* A safe interval search keeps no OPEN or CLOSED list */
+	open_list_hash_table = NULL;
+	closed_list = NULL;
+#else
+	if (options->repair == REPAIR_LPA_STAR)
+	{
+		/* LPA* keeps its own states instead of the lists */
+		open_list_hash_table = NULL;
+		closed_list = NULL;
+		lpa_star = new LPAStarSearch(this);
+	}
+	else
+		start_search();
+#endif
 
 	/* Set the name of the agent */
 	name = p_name;
 
+	/* Held by its creator */
+	ref_count = 1;
+
 #ifdef OPEN_LIST_DATA
 	/* Track the depth of the agent */
 	agent_depth = 0;
 #endif
-
-#ifdef TIME_LIMIT
-	start_time = p_start_time;
-#endif
 }
 
 /*
 * Constructor that begins by eliminating nodes descended from constrained
-* a position given as a parameter
+* positions given as a parameter
 * @param p_astar: The AStar list to copy
-* @param new_constraint: The new constraint to remove all descendants of
-* from the CLOSED and OPEN lists
+* @param new_constraints: The new constraints to remove all descendants of
+* from the CLOSED and OPEN lists, NULL if there are none
+* @param num_constraints: Number of constraints in new_constraints, more than one
+* for the range of constraints of a corridor conflict
 */
-Agent::Agent(Agent* p_agent, Position* new_constraint)
+Agent::Agent(Agent* p_agent, Position* new_constraints, int num_constraints)
+{
+	/* Copy everything but the search from the pre-existing agent */
+	inherit(p_agent, NULL);
+	if (new_constraints == NULL)
+		num_constraints = 0;
+	for (int i = 0; i < num_constraints; i++)
+		add_conflict(&new_constraints[i]);
+
+	/* The shallowest constraint has the most nodes below it */
+	Position* new_constraint = NULL;
+	for (int i = 0; i < num_constraints; i++)
+	{
+		if (new_constraint == NULL || new_constraints[i].get_depth() < new_constraint->get_depth())
+			new_constraint = &new_constraints[i];
+	}
+
+#ifdef SIPP_SEARCH
+	/* A safe interval search keeps no OPEN or CLOSED list */
+	open_list_hash_table = NULL;
+	closed_list = NULL;
+#else
+	if (options->repair == REPAIR_LPA_STAR)
+	{
+		/* Copy the parent's LPA* search and only search again what the constraint changes */
+		open_list_hash_table = NULL;
+		closed_list = NULL;
+		if (!choose_repair(p_agent, new_constraint))
+			lpa_star = new LPAStarSearch(this);
+		else
+		{
+			lpa_star = new LPAStarSearch(p_agent->lpa_star, this);
+			for (int i = 0; i < num_constraints; i++)
+				lpa_star->add_constraint(&new_constraints[i]);
+		}
+	}
+	/* Search again from the start if that is cheaper than repairing the parent's lists */
+	else if (!choose_repair(p_agent, new_constraint))
+		start_search();
+	else
+	{
+		/* Initalize open and closed list hash tables */
+		open_list_hash_table = new AStarNodeList();
+		closed_list = new AStarNodeList();
+
+		/* Copy OPEN list hash table */
+		open_list_hash_table->node_copy(p_agent->get_open_list_hash_table());
+
+		/* Place each node in the OPEN list hash table into the minheap */
+		open_list = 
+			std::priority_queue<AStarNode*, std::vector<AStarNode*>, std::greater<AStarNode> >();
+		open_list_hash_table->heap_place(&open_list);
+
+		/* Copy the closed list as well	*/
+		closed_list->node_copy(p_agent->get_closed_list());
+
+		/* The copied lists lack the duplicates the pre-existing agent dropped */
+		collapse_depth = p_agent->get_collapse_depth();
+
+		/* Remove descendants of the new constraints from the OPEN and CLOSED lists */
+		for (int i = 0; i < num_constraints && status != SEARCH_TIMEOUT; i++)
+		{
+#ifdef PCA_STAR_REMOVAL
+			/*
+			* Only an expanded position has descendants to clear. A range of constraints
+			* may hold positions on the OPEN list, positions the search never generated
+			* or positions an earlier constraint of the range already removed.
+			*/
+			AStarNode* open_node = open_list_hash_table->check_duplicate(&new_constraints[i]);
+			if (open_node != NULL)
+			{
+				open_list_hash_table->remove_hash(open_node);
+				open_node->mark_for_deletion();
+				continue;
+			}
+			if (closed_list->check_duplicate(&new_constraints[i]) == NULL)
+				continue;
+
+			/* The lists of PCA* go back to its thread's pool as soon as it finishes */
+			PathClearAStar path_clear(this, &new_constraints[i]);
+			path_clear.path_clear_a_star();
+
+			/* Lists PCA* did not finish clearing cannot be searched */
+			if (path_clear.get_status() == SEARCH_TIMEOUT)
+				status = SEARCH_TIMEOUT;
+#else
+			/* Follow the children of the constrained node instead of searching for them */
+			DescendantRemoval removal = DescendantRemoval(this, &new_constraints[i]);
+			if (!removal.remove_descendants())
+				status = SEARCH_TIMEOUT;
+#endif
+		}
+
+		/* Dropped states may no longer be duplicates under the new constraint */
+		if (options->collapse_states)
+		{
+			index_collapsed();
+			repair_collapsed(true);
+		}
+	}
+#endif
+}
+
+/*
+* Constructor for an agent whose solution under its constraints is already known.
+* No search state is built, the agent starts out evicted with the given path.
+* @param p_agent: The agent to copy
+* @param new_constraint: The new constraint added to the copied constraints
+* @param p_path: The solution path under the new set of constraints
+*/
+Agent::Agent(Agent* p_agent, Position* new_constraint, std::stack<Coord>* p_path)
+{
+	/* Copy everything but the search from the pre-existing agent */
+	inherit(p_agent, new_constraint);
+
+	/* Keep only the known path */
+	path = *p_path;
+	evicted = true;
+	status = SEARCH_SOLVED;
+	open_list_hash_table = NULL;
+	closed_list = NULL;
+}
+
+/*
+* Constructor for an agent planned by a bounded suboptimal focal search that
+* avoids the paths of other agents. Like an evicted agent only the path is kept.
+* @param p_agent: The agent to copy
+* @param new_constraint: The new constraint added to the copied constraints
+* @param weight: Suboptimality factor, the path costs at most weight times the optimum
+* @param others: Paths of the other agents, NULL if there are none
+*/
+Agent::Agent(Agent* p_agent, Position* new_constraint, double weight, ReservationTable* others)
+{
+	/* Copy everything but the search from the pre-existing agent */
+	inherit(p_agent, new_constraint);
+	open_list_hash_table = NULL;
+	closed_list = NULL;
+	evicted = true;
+
+	/* An agent without a path keeps the status of the search, its creator checks it */
+	FocalSearch focal = FocalSearch(this, weight, others);
+	if (!focal.focal_search())
+	{
+		status = focal.get_status();
+		return;
+	}
+
+	path = std::stack<Coord>(*focal.get_path());
+	lower_bound = focal.get_lower_bound();
+	status = SEARCH_SOLVED;
+}
+
+/*
+* Decide if copying the lists of a pre-existing agent and removing the descendants
+* of the new constraint with PCA* is cheaper than a fresh search. The copy touches
+* every node of both lists, and the nodes deeper than the constraint are the ones
+* PCA* may remove and the search expand again. A fresh search is estimated to
+* expand as many nodes as the pre-existing agent has CLOSED.
+* @param p_agent: The pre-existing agent
+* @param new_constraint: The new constraint, NULL if there is none
+* @return true if the lists should be repaired, false to search again from the start
+*/
+bool Agent::choose_repair(Agent* p_agent, Position* new_constraint)
+{
+	bool repair;
+
+	/* An evicted agent has no lists to copy */
+	if (p_agent->is_evicted())
+		repair = false;
+	/* LPA* repairs the parent's search whenever the parent has one */
+	else if (options->repair == REPAIR_LPA_STAR)
+		repair = p_agent->lpa_star != NULL;
+	else if (options->repair != REPAIR_ADAPTIVE)
+		repair = options->repair == REPAIR_ALWAYS;
+	else
+	{
+		double open_size = p_agent->get_open_list_hash_table()->get_size();
+		double closed_size = p_agent->get_closed_list()->get_size();
+
+		/* Share of the nodes below the constraint, all of them if the goal depth is not known yet */
+		double share = 1;
+		if (new_constraint == NULL)
+			share = 0;
+		else if (p_agent->goal_node != NULL)
+		{
+			double goal_depth = p_agent->goal_node->get_pos()->get_depth();
+			double constraint_depth = new_constraint->get_depth();
+			share = goal_depth > constraint_depth ? (goal_depth - constraint_depth) / goal_depth : 0;
+		}
+
+		double repair_estimate = (open_size + closed_size) * (1 + options->removal_weight * share);
+		double restart_estimate = options->restart_weight * closed_size;
+		repair = repair_estimate <= restart_estimate;
+
+#ifdef REPAIR_DECISION_DATA
+		std::cout << (repair ? "REPAIR " : "RESTART ") << name << ": OPEN " << open_size <<
+			", CLOSED " << closed_size << ", below constraint " << share <<
+			", repair " << repair_estimate << " vs restart " << restart_estimate << std::endl;
+#endif
+	}
+
+	if (repair)
+		repair_count++;
+	else
+		restart_count++;
+	return repair;
+}
+
+/*
+* Copy everything but the search state from a pre-existing agent
+* @param p_agent: The agent to copy
+* @param new_constraint: The new constraint added to the copied constraints
+*/
+void Agent::inherit(Agent* p_agent, Position* new_constraint)
 {
 	/* Get the start and goal coordinate of the A* Search */
 	goal = new Coord(*(p_agent->get_goal()));
 
 	/* No goal node is found initially */
 	goal_node = NULL;
+	evicted = false;
+	lower_bound = -1;
+	status = SEARCH_RUNNING;
 
 	/* Store the start Coord */
 	start_coord = new Coord(p_agent->get_start());
@@ -96,66 +338,142 @@ Agent::Agent(Agent* p_agent, Position* new_constraint)
 	/* Set the name of the agent */
 	name = p_agent->get_name();
 
-	/* Initalize open and closed list hash tables */
-	open_list_hash_table = new AStarNodeList();
-	closed_list = new AStarNodeList();
+	/* Held by the CBSNode that creates it */
+	ref_count = 1;
+
+	/* Share the deadline and configuration of the agent's CBS Tree */
+	cancel_token = p_agent->get_cancel_token();
+	options = p_agent->get_options();
 
 	/* Copy the constraints and add the new constraint */
 	constraints = *(p_agent->get_constraints());
-	constraints.emplace(HashStruct::hash_pos(new_constraint), *new_constraint);
-
-#ifdef CBS_CLASSIC
-	/* Using CBS Classic (no PCA*) */
-	open_list = std::priority_queue<AStarNode*, std::vector<AStarNode*>, std::greater<AStarNode> >();
-
-	/* Put the start node in the OPEN list */
-	Position start_pos = Position(p_agent->get_start(), 0);
-	AStarNode* start_node = new AStarNode(&start_pos, NULL, calc_cost(&start_pos));
-	open_list.emplace(start_node);
-	open_list_hash_table->add_node(start_node);
-#else
-	/* Copy OPEN list hash table */
-	open_list_hash_table->node_copy(p_agent->get_open_list_hash_table());
+	constraint_hash = p_agent->get_constraint_hash();
+	horizon = p_agent->get_horizon();
+	landmarks = std::vector<Position>(p_agent->landmarks);
+	landmark_depth = p_agent->landmark_depth;
+	length_depth = p_agent->length_depth;
+	if (new_constraint != NULL)
+		add_conflict(new_constraint);
 
-	/* Place each node in the OPEN list hash table into the minheap */
-	open_list = 
-		std::priority_queue<AStarNode*, std::vector<AStarNode*>, std::greater<AStarNode> >();
-	open_list_hash_table->heap_place(&open_list);
+	/* No duplicates dropped yet */
+	collapse_depth = USHRT_MAX;
 
-	/* Copy the closed list as well	*/
-	closed_list->node_copy(p_agent->get_closed_list());
-
-	/* Remove descendants of new_constraint from the OPEN and CLOSED lists */
-	if (new_constraint != NULL)
-	{
-		path_clear = new PathClearAStar(this, new_constraint);
-		path_clear->path_clear_a_star();
-	}
-#endif
+	/* Only the child constructor that searches sets up LPA* */
+	lpa_star = NULL;
 
 #ifdef OPEN_LIST_DATA
 	/* Increment the agents depth */
 	agent_depth = p_agent->get_depth() + 1;
 #endif
-
-#ifdef TIME_LIMIT
-	start_time = p_agent->start_time;
-#endif
 }
 
 /*
-* Add a conflict to the conflict hash table
+* Add a conflict to the conflict hash table. With target reasoning a finished agent
+* stays at its goal, so a constraint on the goal is also a length constraint.
 * @param conflict: Pointer to the position to add to the list of conflicts
 */
 void Agent::add_conflict(Position* conflict)
 {
-	constraints.emplace(HashStruct::hash_pos(conflict),*conflict);
+	/* Only a constraint new to the set changes the hash */
+	if (constraints.emplace(HashStruct::hash_pos(conflict), *conflict).second)
+		constraint_hash ^= HashStruct::hash_constraint(conflict);
+
+	/* Move the horizon past the latest constraint */
+	if (conflict->get_depth() > horizon)
+		horizon = conflict->get_depth();
+
+	/* The agent may not finish until after its latest constraint on its goal */
+	if (
+		options->target_reasoning && *conflict->get_coord() == *goal &&
+		conflict->get_depth() >= length_depth
+		)
+		length_depth = conflict->get_depth() + 1;
+}
+
+/*
+* Add a positive constraint, made by a disjoint split of a CBSNode. Only the A* Search
+* enforces landmarks, so they must be added before the agent searches.
+* @param landmark: The position the agent must occupy at its depth
+*/
+void Agent::add_landmark(Position* landmark)
+{
+	if (has_landmark(landmark))
+		return;
+	landmarks.push_back(*landmark);
+	constraint_hash ^= HashStruct::hash_landmark(landmark);
+
+	/* Time matters up to the landmark, and the agent must not leave before it */
+	if (landmark->get_depth() > horizon)
+		horizon = landmark->get_depth();
+	if (landmark->get_depth() > landmark_depth)
+		landmark_depth = landmark->get_depth();
+}
+
+/*
+* Check if the agent must be at a position
+* @param pos: The position to check
+* @return true if the position is one of the agent's landmarks
+*/
+bool Agent::has_landmark(Position* pos)
+{
+	int len = landmarks.size();
+	for (int i = 0; i < len; i++)
+	{
+		if (landmarks[i] == *pos)
+			return true;
+	}
+	return false;
 }
 
 /*
 * Perform the A* search and save the goal node as goal_node
+* @exceptions: Throws an OutOfNodesException if the agent has no solution and a
+* TerminalException if the time limit is reached
 */
 void Agent::find_solution()
+{
+	switch (solve())
+	{
+	case SEARCH_SOLVED:
+		return;
+	case SEARCH_TIMEOUT:
+		throw TerminalException("TIME LIMIT EXCEEDED");
+	default:
+		throw OutOfNodesException();
+	}
+}
+
+/*
+* Perform the A* search and save the goal node as goal_node without throwing
+* @return the outcome of the search, also kept as the agent's status
+*/
+SearchStatus Agent::solve()
+{
+	/* The solution is already known, or the search cannot run */
+	if (goal_node != NULL || evicted || status == SEARCH_TIMEOUT)
+		return status;
+
+#ifdef SIPP_SEARCH
+	return solve_sipp();
+#endif
+
+	if (lpa_star != NULL)
+		return solve_lpa_star();
+
+	/* Hoist the configuration out of the expansion loop, PCA* never marks nodes of classic CBS */
+	if (options->repair == REPAIR_NEVER)
+		return options->collapse_states ? expand_nodes<true, true>() : expand_nodes<true, false>();
+	return options->collapse_states ? expand_nodes<false, true>() : expand_nodes<false, false>();
+}
+
+/*
+* Expand nodes until the goal is popped or the search stops. The configuration is
+* a template parameter so a build serving several configurations keeps none of
+* their branches in the loop.
+* @return the outcome of the search, also kept as the agent's status
+*/
+template <bool CLASSIC, bool COLLAPSE>
+SearchStatus Agent::expand_nodes()
 {
 #ifdef OPEN_LIST_DATA
 	/* Create a variable for the number of nodes popped from the OPEN list */
@@ -163,26 +481,32 @@ void Agent::find_solution()
 	/* Create a variable for the number of nodes added to the OPEN list */
 	int added = 0;
 #endif
+
+	/* Nodes at the depth bound stay on the OPEN list without being expanded */
+	unsigned short depth_bound = get_depth_bound();
+	std::vector<AStarNode*> bounded = std::vector<AStarNode*>();
 	
 	while (!open_list.empty())
 	{
-#ifdef TIME_LIMIT
-		/* Make sure the time limit has not been exceeded */
-		if ((std::clock() - start_time) / CLOCKS_PER_SEC > TIME_LIMIT)
-			throw TerminalException("TIME LIMIT EXCEEDED");
-#endif
+		/* Make sure the search has not been cancelled or run out of time */
+		if (cancel_token != NULL && cancel_token->poll())
+		{
+			for (unsigned int i = 0; i < bounded.size(); i++)
+				open_list.push(bounded[i]);
+			status = SEARCH_TIMEOUT;
+			return status;
+		}
 		/* Pop min cost from open_list and remove from hash table */
 		AStarNode* heap_top = open_list.top();
 		open_list.pop();
 
-#ifndef CBS_CLASSIC
-		/* Delete the node if it is marked for deletion */
-		if (heap_top->get_del_mark() == true)
+		/* Delete the node if it is marked for deletion (PCA* never marks nodes of classic CBS) */
+		if (!CLASSIC && heap_top->get_del_mark() == true)
 		{
 			delete heap_top;
 			continue;
 		}
-#endif
+		count_expansion();
 
 #ifdef A_STAR_SEARCH_DATA
 		std::cout << "COORD: " <<  *heap_top->get_pos()->get_coord() <<
@@ -203,12 +527,15 @@ void Agent::find_solution()
 			throw TerminalException("Could not find node from heap in hash table.");
 
 		/* Check if the node is a solution, if it is, return it */
-		if (*top->get_pos()->get_coord() == *goal)
+		if (is_arrival(top->get_pos()))
 		{
 			goal_node = top;
 
 			/* Place the goal node back into the OPEN list (it will be removed by PCA*) */
 			open_list.push(top);
+			for (unsigned int i = 0; i < bounded.size(); i++)
+				open_list.push(bounded[i]);
+			status = SEARCH_SOLVED;
 
 #ifdef A_STAR_SEARCH_DATA
 			std::cout << "END OF SEARCH" << std::endl;
@@ -227,54 +554,131 @@ void Agent::find_solution()
 			std::cout << "OPEN LIST SIZE: " << open_list_hash_table->get_list()->size() << std::endl;
 			std::cout << "CLOSED LIST SIZE: " << closed_list->get_list()->size() << std::endl;
 #endif
-			return;
+			return status;
 		}
 
-		/* Generate successors */
-		std::vector<Position> successors = std::vector<Position>();
-		get_successors(top->get_pos(), &successors);
-
-		/* For each successor, check if it is in the OPEN list and CLOSED list */
-		int len = successors.size();
-		for (int i = 0; i < len; i++)
+		/* Successors would pass the depth bound */
+		if (top->get_pos()->get_depth() >= depth_bound)
 		{
-			/* Check if the successor is in either the OPEN or CLOSED list */
-			AStarNode* check_open_list = 
-				open_list_hash_table->check_duplicate(&successors[i]);
-			AStarNode* check_closed_list = 
-				closed_list->check_duplicate(&successors[i]);
-
-			/* If the successor is not a duplicate, add it to the OPEN list */
-			if (check_open_list == NULL && check_closed_list == NULL)
-			{
-				/* Create a new node and add it to the OPEN list (both heap and hash table) */
-				AStarNode* add_node = 
-					new AStarNode(&successors[i], top, calc_cost(&successors[i]));
-
-				/* Add node to the hash table and minheap */
-				open_list_hash_table->add_node(add_node);
-				open_list.push(add_node);
+			bounded.push_back(top);
+			continue;
+		}
 
+		/* Generate successors and move top to the CLOSED list */
 #ifdef OPEN_LIST_DATA
-				/* Increment added counter */
-				added++;
+		added += expand_node<COLLAPSE>(top);
+#else
+		expand_node<COLLAPSE>(top);
 #endif
-			}
-			else if (check_open_list != NULL)
-				check_open_list->add_parent(top);
-			else if (check_closed_list != NULL)
-				check_closed_list->add_parent(top);
+	}
+
+	/* Keep the OPEN list whole, the nodes at the bound are still unexpanded */
+	for (unsigned int i = 0; i < bounded.size(); i++)
+		open_list.push(bounded[i]);
+
+	/* Without the SEARCH_DEPTH cap the bound only cuts off agents with no solution */
+	if (!bounded.empty() && depth_bound < sound_depth_bound())
+		status = SEARCH_DEPTH_EXCEEDED;
+	else
+		status = SEARCH_INFEASIBLE;
+	return status;
+}
+
+/*
+* Generate the successors of a node and move it from the OPEN to the CLOSED list
+* @param top: A node of the OPEN list hash table, already popped from the heap
+* @return the number of successors added to the OPEN list
+*/
+template <bool COLLAPSE>
+int Agent::expand_node(AStarNode* top)
+{
+	int added = 0;
+
+	/* Generate successors */
+	std::vector<Position> successors = std::vector<Position>();
+	get_successors(top->get_pos(), &successors);
+
+	/* For each successor, check if it is in the OPEN list and CLOSED list */
+	int len = successors.size();
+	for (int i = 0; i < len; i++)
+	{
+		/* Check if the successor is in either the OPEN or CLOSED list */
+		AStarNode* check_open_list = 
+			open_list_hash_table->check_duplicate(&successors[i]);
+		AStarNode* check_closed_list = 
+			closed_list->check_duplicate(&successors[i]);
+
+		/* If the successor is not a duplicate, add it to the OPEN list */
+		if (check_open_list == NULL && check_closed_list == NULL)
+		{
+			/* Beyond the horizon a cell reached no later makes this state a duplicate */
+			if (COLLAPSE && collapse_state(&successors[i]))
+				continue;
+
+			/* Create a new node and add it to the OPEN list (both heap and hash table) */
+			AStarNode* add_node = 
+				new AStarNode(&successors[i], top, calc_cost(&successors[i]));
+
+			/* Add node to the hash table and minheap */
+			open_list_hash_table->add_node(add_node);
+			open_list.push(add_node);
+			added++;
 		}
+		else if (check_open_list != NULL)
+			check_open_list->add_parent(top);
+		else if (check_closed_list != NULL)
+			check_closed_list->add_parent(top);
+	}
+
+	/* Add top to the CLOSED list */
+	closed_list->add_node(top);
 
-		/* Add top to the CLOSED list */
-		closed_list->add_node(top);
+	/* Remove the node from the OPEN list without deleting the node */
+	open_list_hash_table->remove_hash(top);
+	return added;
+}
 
-		/* Remove the node from the OPEN list without deleting the node */
-		open_list_hash_table->remove_hash(top);
+/*
+* Find the solution with a safe interval search, keeping only the path. The
+* agent is marked evicted since it has no OPEN or CLOSED list.
+* @return the outcome of the search
+*/
+SearchStatus Agent::solve_sipp()
+{
+	SIPPSearch sipp = SIPPSearch(this);
+	if (!sipp.sipp_search())
+	{
+		status = sipp.get_status();
+		return status;
 	}
+	status = SEARCH_SOLVED;
+	path = *sipp.get_path();
+	evicted = true;
+	return status;
+}
 
-	/* You should never run out of nodes in A* search */
-	throw OutOfNodesException();
+/*
+* Find the solution with the incremental LPA* search. The search is kept so the
+* children of the agent can repair it, only the path is stored.
+* @return the outcome of the search
+*/
+SearchStatus Agent::solve_lpa_star()
+{
+	/* The search already finished */
+	if (status != SEARCH_RUNNING)
+		return status;
+
+	status = lpa_star->compute_shortest_path();
+	if (status == SEARCH_SOLVED)
+		path = lpa_star->get_path();
+
+	/* Without the SEARCH_DEPTH cap the bound only cuts off agents with no solution */
+	else if (
+		status == SEARCH_INFEASIBLE && lpa_star->get_reached_bound() &&
+		get_depth_bound() < sound_depth_bound()
+		)
+		status = SEARCH_DEPTH_EXCEEDED;
+	return status;
 }
 
 /* 
@@ -318,14 +722,15 @@ void Agent::get_successors(Position* pos, std::vector<Position>* successors)
 
 	/* 
 	* Add each possible successor if it is an existing coordinate, 
-	* is not blocked by an obstacle and is not constrained.
+	* is not blocked by an obstacle, is not constrained and can keep to the landmarks.
 	*/
 	int num_successors = possible_successors.size();
 	for (int i = 0; i < num_successors; i++)
 	{
 		if (
 			world->check_coord(possible_successors[i]->get_coord()) &&
-			constraints.find(HashStruct::hash_pos(possible_successors[i])) == constraints.end()
+			constraints.find(HashStruct::hash_pos(possible_successors[i])) == constraints.end() &&
+			(landmarks.empty() || reaches_landmarks(possible_successors[i]))
 			)
 			successors->push_back(*possible_successors[i]);
 	}
@@ -342,13 +747,18 @@ void Agent::get_successors(Position* pos, std::vector<Position>* successors)
 */
 std::stack<Coord> Agent::get_solution()
 {
-	/* Initialize the stack */
-	std::stack<Coord> path = std::stack<Coord>();
+	/* Use the stored path if the solution was already traced (or the agent was evicted) */
+	if (!path.empty())
+		return path;
 
 	/* Find the solution if it has not yet been found */
 	if (goal_node == NULL)
 		find_solution();
 
+	/* A safe interval search only produces the path */
+	if (!path.empty())
+		return path;
+
 	/* Push the goal node's Coord object onto the stack */
 	path.push(goal_node->get_pos()->get_coord());
 
@@ -385,6 +795,200 @@ std::stack<Coord> Agent::get_solution()
 	return path;
 }
 
+/*
+* Resume the finished search until every state that can reach the goal at a given
+* depth is expanded. The goal state of that depth then has every arrival at the
+* goal as a parent, so the paths of that cost are read from the parent bitmaps
+* instead of searching again. States the search dropped as duplicates are generated
+* first, a path of a higher cost may wait where the collapsed search did not.
+* @param cost: Depth of the goal arrivals
+* @return SEARCH_SOLVED if the goal is reached at that depth, SEARCH_INFEASIBLE if it
+* is not, SEARCH_DEPTH_EXCEEDED if the depth is past the depth bound, SEARCH_TIMEOUT
+* if the search was stopped and SEARCH_UNSUPPORTED for an agent without OPEN and CLOSED lists
+*/
+SearchStatus Agent::continue_search(unsigned short cost)
+{
+	/* LPA* and focal agents never keep the lists, so an evicted one is not rebuilt first */
+	if (options->repair == REPAIR_LPA_STAR || lower_bound != -1)
+		return SEARCH_UNSUPPORTED;
+
+	/* Continue from the search that found the solution */
+	if (evicted)
+		restore();
+	if (open_list_hash_table == NULL)
+		return SEARCH_UNSUPPORTED;
+	if (goal_node == NULL && solve() != SEARCH_SOLVED)
+		return status;
+
+	unsigned short depth_bound = get_depth_bound();
+	if (cost > depth_bound)
+		return SEARCH_DEPTH_EXCEEDED;
+
+	/* Paths of a higher cost may wait where duplicates were dropped */
+	if (collapse_depth != USHRT_MAX)
+	{
+		repair_collapsed(false);
+		collapse_depth = USHRT_MAX;
+		collapsed.clear();
+	}
+
+	/* Nodes that cannot reach the goal by the depth go back on the OPEN list unexpanded */
+	std::vector<AStarNode*> kept = std::vector<AStarNode*>();
+	while (!open_list.empty())
+	{
+		/* Make sure the search has not been cancelled or run out of time */
+		if (cancel_token != NULL && cancel_token->poll())
+		{
+			for (unsigned int i = 0; i < kept.size(); i++)
+				open_list.push(kept[i]);
+			return SEARCH_TIMEOUT;
+		}
+
+		AStarNode* top = open_list.top();
+		open_list.pop();
+
+		/* Delete the node if it is marked for deletion */
+		if (top->get_del_mark() == true)
+		{
+			delete top;
+			continue;
+		}
+
+		/* The agent leaves at its goal, other nodes need time left to reach it */
+		Position* pos = top->get_pos();
+		if (is_arrival(pos) || pos->get_depth() >= cost ||
+			pos->get_depth() >= depth_bound ||
+			pos->get_coord()->moves_to(goal) > cost - pos->get_depth())
+		{
+			kept.push_back(top);
+			continue;
+		}
+
+		count_expansion();
+		expand_node<false>(top);
+	}
+	for (unsigned int i = 0; i < kept.size(); i++)
+		open_list.push(kept[i]);
+
+	Position arrival = Position(*goal, cost);
+	if (open_list_hash_table->check_duplicate(&arrival) == NULL)
+		return SEARCH_INFEASIBLE;
+	return SEARCH_SOLVED;
+}
+
+/*
+* Get the cells of every path reaching the goal at a given depth, one layer per
+* depth (the multi-valued decision diagram of that cost)
+* @param cost: Depth of the goal arrivals
+* @param layers: Filled with the cells of each depth, from the start to the goal
+* @return the outcome of continue_search, the layers are only filled if the goal is reached
+*/
+SearchStatus Agent::get_mdd(unsigned short cost, std::vector<std::vector<Coord> >* layers)
+{
+	SearchStatus arrivals = continue_search(cost);
+	if (arrivals != SEARCH_SOLVED)
+		return arrivals;
+
+	*layers = std::vector<std::vector<Coord> >(cost + 1);
+	(*layers)[cost].push_back(*goal);
+	for (unsigned short depth = cost; depth > 0; depth--)
+	{
+		/* Every parent of the layer, each cell once */
+		std::unordered_map<unsigned int, bool> added = std::unordered_map<unsigned int, bool>();
+		for (unsigned int i = 0; i < (*layers)[depth].size(); i++)
+		{
+			Position pos = Position((*layers)[depth][i], depth);
+			unsigned short parents = get_arrival_node(&pos)->get_parent_bitmap();
+			for (unsigned short bit = 1; parents != 0; bit = bit << 1)
+			{
+				if ((parents & bit) == 0)
+					continue;
+				parents &= ~bit;
+
+				Coord parent = HashStruct::hash_to_coord(bit, pos.get_coord());
+				if (added.emplace(HashStruct::hash_coord(&parent), true).second)
+					(*layers)[depth - 1].push_back(parent);
+			}
+		}
+	}
+	return SEARCH_SOLVED;
+}
+
+/*
+* Enumerate the paths reaching the goal at a given depth
+* @param cost: Depth of the goal arrivals
+* @param max_paths: Most paths to enumerate, their number grows quickly with the cost
+* @param paths: Paths are appended to it, the start at the top of each stack
+* @return the outcome of continue_search, paths are only appended if the goal is reached
+*/
+SearchStatus Agent::get_paths(
+	unsigned short cost, unsigned int max_paths, std::vector<std::stack<Coord> >* paths
+	)
+{
+	SearchStatus arrivals = continue_search(cost);
+	if (arrivals != SEARCH_SOLVED)
+		return arrivals;
+
+	/* Cell of the current path at each depth and the parents of it not followed yet */
+	std::vector<Coord> trail = std::vector<Coord>(cost + 1, *goal);
+	std::vector<unsigned short> untried = std::vector<unsigned short>(cost + 1, 0);
+	Position arrival = Position(*goal, cost);
+	untried[cost] = get_arrival_node(&arrival)->get_parent_bitmap();
+
+	/* Follow the parents depth first from the goal back to the start */
+	unsigned int found = 0;
+	int depth = cost;
+	while (depth <= cost && found < max_paths)
+	{
+		if (depth == 0)
+		{
+			std::stack<Coord> path = std::stack<Coord>();
+			for (int i = cost; i >= 0; i--)
+				path.push(trail[i]);
+			paths->push_back(path);
+			found++;
+			depth++;
+			continue;
+		}
+
+		/* Every parent was followed, go back to the child */
+		if (untried[depth] == 0)
+		{
+			depth++;
+			continue;
+		}
+
+		unsigned short bit = 1;
+		while ((untried[depth] & bit) == 0)
+			bit = bit << 1;
+		untried[depth] &= ~bit;
+
+		Coord parent = HashStruct::hash_to_coord(bit, &trail[depth]);
+		trail[depth - 1] = parent;
+		Position parent_pos = Position(parent, depth - 1);
+		untried[depth - 1] = get_arrival_node(&parent_pos)->get_parent_bitmap();
+		depth--;
+	}
+	return SEARCH_SOLVED;
+}
+
+/*
+* Find the node of a state on a path to a goal arrival, the arrival is on the OPEN
+* list and the states before it are expanded
+* @param pos: The position of the state
+* @return the node
+* @exceptions: Throws a TerminalException if the node is in neither list
+*/
+AStarNode* Agent::get_arrival_node(Position* pos)
+{
+	AStarNode* node = closed_list->check_duplicate(pos);
+	if (node == NULL)
+		node = open_list_hash_table->check_duplicate(pos);
+	if (node == NULL)
+		throw TerminalException("Node of a goal arrival not found in the A* lists.");
+	return node;
+}
+
 /*
 * Print the solution to the console 
 */
@@ -454,24 +1058,395 @@ double Agent::calc_cost(Position* pos)
 int Agent::get_cost()
 {
 	/* Find the solution if it has not been found yet */
-	if (goal_node == NULL)
+	if (!evicted && goal_node == NULL)
 		find_solution();
 
+	/* An evicted agent (or one searched by SIPP or LPA*) only keeps its path */
+	if (evicted || lpa_star != NULL)
+		return path.size() - 1;
+
 	/* The cost is equal to the depth of the goal node */
 	return goal_node->get_pos()->get_depth();
 }
 
 /*
-* Destructor
+* Get a lower bound on the agent's optimal cost under its constraints
+* @return the cost for agents with an optimal solution, the focal search
+* lower bound otherwise
 */
-Agent::~Agent()
+int Agent::get_lower_bound()
 {
+	if (lower_bound == -1)
+		return get_cost();
+	return lower_bound;
+}
+
+/*
+* Create empty OPEN and CLOSED lists and place the start node on the OPEN list
+*/
+void Agent::start_search()
+{
+	/* Initialize lists and hash tables */
+	open_list = std::priority_queue<AStarNode*, std::vector<AStarNode*>, std::greater<AStarNode> >();
+	open_list_hash_table = new AStarNodeList();
+	closed_list = new AStarNodeList();
+
+	/* No cell has been reached beyond the horizon yet */
+	collapsed.clear();
+	collapse_depth = USHRT_MAX;
+
+	/* Place the root into the OPEN list */
+	Position start_pos = Position(start_coord, 0);
+	AStarNode* start_node = new AStarNode(&start_pos, NULL, calc_cost(&start_pos));
+	open_list.emplace(start_node);
+	open_list_hash_table->add_node(start_node);
+}
+
+/*
+* Delete the OPEN and CLOSED lists and every node they hold
+*/
+void Agent::clear_search()
+{
+	/* Nodes marked for deletion by PCA* are only referenced by the heap */
+	while (!open_list.empty())
+	{
+		AStarNode* top = open_list.top();
+		open_list.pop();
+		if (top->get_del_mark() == true)
+			delete top;
+	}
+
 	delete open_list_hash_table;
 	delete closed_list;
-	delete goal;
-	delete start_coord;
+	delete lpa_star;
+	open_list_hash_table = NULL;
+	closed_list = NULL;
+	lpa_star = NULL;
+	collapsed.clear();
+}
+
+/*
+* Check, without searching, that the goal stays reachable under the agent's constraints
+* and one more constraint
+* @param new_constraint: The constraint added to the agent's constraints, NULL if none
+* @return false if the goal is disconnected from the start or the constraints block
+* every cell the agent can occupy at some depth, true otherwise
+*/
+bool Agent::can_reach_goal(Position* new_constraint)
+{
+	std::vector<Position> new_constraints = std::vector<Position>();
+	if (new_constraint != NULL)
+		new_constraints.push_back(*new_constraint);
+	return can_reach_goal(&new_constraints);
+}
 
-#ifndef CBS_CLASSIC
-	delete path_clear;
+/*
+* Check, without searching, that the goal stays reachable under the agent's constraints
+* and several more constraints. The cells the agent can occupy are followed one depth at
+* a time. An agent can always wait, so the set of cells only shrinks by the constraints
+* at the next depth. Once it holds more cells than there are constraints left it never
+* empties, and since the start and goal are connected the goal is reachable.
+* @param new_constraints: The constraints added to the agent's constraints
+* @return false if the goal is disconnected from the start or the constraints block
+* every cell the agent can occupy at some depth, true otherwise
+*/
+bool Agent::can_reach_goal(std::vector<Position>* new_constraints)
+{
+	/* The start and goal must share a connected component of the World */
+	if (!world->connected(start_coord, goal))
+		return false;
+
+	/* The new constraints the agent does not already have, keyed by position hash */
+	std::unordered_map<unsigned int, Position> added;
+	unsigned short last_depth = horizon;
+	for (unsigned int i = 0; i < new_constraints->size(); i++)
+	{
+		Position* constraint = &(*new_constraints)[i];
+		unsigned int hash = HashStruct::hash_pos(constraint);
+		if (constraints.find(hash) != constraints.end())
+			continue;
+		added.emplace(hash, *constraint);
+		if (constraint->get_depth() > last_depth)
+			last_depth = constraint->get_depth();
+	}
+
+	/* Number of constraints at each depth, the new ones included */
+	std::vector<int> depth_counts = std::vector<int>(last_depth + 1, 0);
+	for (auto it = constraints.begin(); it != constraints.end(); it++)
+		depth_counts[it->second.get_depth()]++;
+	for (auto it = added.begin(); it != added.end(); it++)
+		depth_counts[it->second.get_depth()]++;
+
+	/* Constraints below the depth of the current cells */
+	int remaining = constraints.size() + added.size() - depth_counts[0];
+
+	/* Cells the agent can occupy at the current depth, keyed by coordinate hash */
+	std::unordered_map<unsigned int, Coord> cells;
+	cells.emplace(HashStruct::hash_coord(start_coord), *start_coord);
+	for (unsigned short depth = 1; ; depth++)
+	{
+		/* The agent leaves at its goal, and enough cells can never all be blocked */
+		if (cells.find(HashStruct::hash_coord(goal)) != cells.end() ||
+			static_cast<int>(cells.size()) > remaining)
+			return true;
+
+		/* Move or wait into every cell not constrained at the next depth */
+		std::unordered_map<unsigned int, Coord> next_cells;
+		for (auto it = cells.begin(); it != cells.end(); it++)
+		{
+			Position pos = Position(it->second, depth - 1);
+			std::vector<Position> successors = std::vector<Position>();
+			get_successors(&pos, &successors);
+			for (unsigned int i = 0; i < successors.size(); i++)
+			{
+				if (added.find(HashStruct::hash_pos(&successors[i])) != added.end())
+					continue;
+				next_cells.emplace(
+					HashStruct::hash_coord(successors[i].get_coord()), *successors[i].get_coord()
+					);
+			}
+		}
+
+		/* Every cell is blocked */
+		if (next_cells.empty())
+			return false;
+
+		if (depth <= last_depth)
+			remaining -= depth_counts[depth];
+		cells.swap(next_cells);
+	}
+}
+
+/*
+* Get the deepest position the search generates. Past the horizon an agent can move
+* freely, so from any cell of its connected component it reaches the goal in fewer
+* moves than the component has cells. A solution therefore exists above the horizon
+* plus the component size if one exists at all. The heuristic distance is added as
+* slack. The bound is capped by the search depth of the options (SEARCH_DEPTH).
+* @return the depth bound of the agent's search
+*/
+unsigned short Agent::get_depth_bound()
+{
+	int bound = sound_depth_bound();
+	if (bound > options->search_depth)
+		return options->search_depth;
+	return bound;
+}
+
+/*
+* Get the depth bound of the agent's search before it is capped by SEARCH_DEPTH
+* @return the horizon plus the heuristic distance plus the component size
+*/
+int Agent::sound_depth_bound()
+{
+	return horizon + start_coord->moves_to(goal) + world->get_component_size(goal);
+}
+
+/*
+* Check if a position can still be at every later landmark in time. A landmark of
+* the same depth leaves only its own cell.
+* @param pos: The position to check
+* @return false if some landmark is more moves away than it is deep past the position
+*/
+bool Agent::reaches_landmarks(Position* pos)
+{
+	int len = landmarks.size();
+	for (int i = 0; i < len; i++)
+	{
+		int depth_diff = landmarks[i].get_depth() - pos->get_depth();
+		if (depth_diff < 0)
+			continue;
+
+		if (landmarks[i].get_coord()->moves_to(pos->get_coord()) > depth_diff)
+			return false;
+	}
+	return true;
+}
+
+/*
+* Check if a position of the search ends the agent's path. The agent leaves the world
+* (or stays at its goal with target reasoning) at its goal, unless a landmark or a
+* length constraint still lies ahead of it.
+* @param pos: The position to check
+* @return true if the position is at the goal no earlier than the latest landmark
+* and the length constraints
+*/
+bool Agent::is_arrival(Position* pos)
+{
+	return
+		*pos->get_coord() == *goal && pos->get_depth() >= landmark_depth &&
+		pos->get_depth() >= length_depth;
+}
+
+/*
+* Check if a position is a duplicate of an earlier state beyond the horizon. Past the
+* latest constraint an agent may wait anywhere, so reaching a cell at the same or a
+* later depth than a state already in the lists cannot lead to a cheaper solution.
+* States up to one step past the horizon are never dropped.
+* @param pos: The position of a successor that is in neither the OPEN nor CLOSED list
+* @return true if the position is a duplicate and should not be generated,
+* false if it should be (its cell is recorded if it is beyond the horizon)
+*/
+bool Agent::collapse_state(Position* pos)
+{
+	/* Time still matters up to the horizon */
+	unsigned short depth = pos->get_depth();
+	if (depth <= horizon)
+		return false;
+
+	/* Record the cell the first time it is reached beyond the horizon */
+	unsigned int key = HashStruct::hash_coord(pos->get_coord());
+	std::unordered_map<unsigned int, unsigned short>::iterator found = collapsed.find(key);
+	if (found == collapsed.end())
+	{
+		collapsed.emplace(key, depth);
+		return false;
+	}
+
+	/* Reached earlier, so this state is a duplicate */
+	if (found->second <= depth)
+	{
+		if (depth < collapse_depth)
+			collapse_depth = depth;
+		return true;
+	}
+
+	/* Reached earlier than before */
+	found->second = depth;
+	return false;
+}
+
+/*
+* Rebuild the earliest depths of the cells beyond the horizon from the OPEN and
+* CLOSED lists, after they were copied and cleared of a new constraint by PCA*
+*/
+void Agent::index_collapsed()
+{
+	collapsed.clear();
+
+	AStarNodeList* lists[2] = { open_list_hash_table, closed_list };
+	for (int i = 0; i < 2; i++)
+	{
+		std::unordered_multimap<unsigned int, AStarNode*>* map = lists[i]->get_list()->get_map();
+		for (auto it = map->begin(); it != map->end(); it++)
+		{
+			Position* pos = it->second->get_pos();
+			if (pos->get_depth() <= horizon)
+				continue;
+
+			/* Keep the earliest depth of each cell */
+			unsigned int key = HashStruct::hash_coord(pos->get_coord());
+			std::unordered_map<unsigned int, unsigned short>::iterator found = collapsed.find(key);
+			if (found == collapsed.end())
+				collapsed.emplace(key, pos->get_depth());
+			else if (pos->get_depth() < found->second)
+				found->second = pos->get_depth();
+		}
+	}
+}
+
+/*
+* Generate the dropped successors of copied CLOSED nodes that are no longer duplicates.
+* A state is dropped because an earlier state of its cell was in the lists, but PCA*
+* may have removed that state or the new constraint may have moved the horizon past it.
+* The successors are added to the OPEN list as if their parents were expanded again.
+* @param collapse: False to generate every dropped successor, duplicates included
+*/
+void Agent::repair_collapsed(bool collapse)
+{
+	/* Nothing was dropped */
+	if (collapse_depth == USHRT_MAX)
+		return;
+
+	std::unordered_multimap<unsigned int, AStarNode*>* map = closed_list->get_list()->get_map();
+	for (auto it = map->begin(); it != map->end(); it++)
+	{
+		/* Only nodes expanded into the depths where states were dropped */
+		AStarNode* parent = it->second;
+		if (parent->get_pos()->get_depth() + 1 < collapse_depth)
+			continue;
+
+		std::vector<Position> successors = std::vector<Position>();
+		get_successors(parent->get_pos(), &successors);
+
+		int len = successors.size();
+		for (int i = 0; i < len; i++)
+		{
+			AStarNode* found = open_list_hash_table->check_duplicate(&successors[i]);
+			if (found == NULL)
+				found = closed_list->check_duplicate(&successors[i]);
+
+			/* A successor generated again by another parent gets this parent too */
+			if (found != NULL)
+			{
+				if (!found->check_parent(parent->get_pos()->get_coord()))
+					found->add_parent(parent);
+				continue;
+			}
+
+			/* Still a duplicate */
+			if (collapse && collapse_state(&successors[i]))
+				continue;
+
+			AStarNode* add_node = 
+				new AStarNode(&successors[i], parent, calc_cost(&successors[i]));
+			open_list_hash_table->add_node(add_node);
+			open_list.push(add_node);
+		}
+	}
+}
+
+/*
+* Release the OPEN and CLOSED lists (or LPA* search), keeping the path, cost and constraints.
+* Children of an evicted agent search from scratch rather than copying its lists.
+*/
+void Agent::evict()
+{
+	/* Only a solved agent can be evicted, its path must outlive the lists */
+	if (evicted || (goal_node == NULL && (lpa_star == NULL || status != SEARCH_SOLVED)))
+		return;
+	get_solution();
+
+	clear_search();
+	goal_node = NULL;
+	evicted = true;
+}
+
+/*
+* Rebuild the OPEN and CLOSED lists (or LPA* search) of an evicted agent with a new search
+* under the same constraints. The new search reaches the goal at the same cost but may
+* break ties differently, so the stored path is kept as the solution.
+*/
+void Agent::restore()
+{
+	/* A focal search path is not the A* path, so focal agents stay evicted */
+	if (!evicted || lower_bound != -1)
+		return;
+
+#ifdef SIPP_SEARCH
+	/* A safe interval search has no lists to rebuild */
+#else
+	std::stack<Coord> stored_path = path;
+	if (options->repair == REPAIR_LPA_STAR)
+	{
+		lpa_star = new LPAStarSearch(this);
+		status = SEARCH_RUNNING;
+	}
+	else
+		start_search();
+	evicted = false;
+	find_solution();
+	path = stored_path;
 #endif
+}
+
+/*
+* Destructor
+*/
+Agent::~Agent()
+{
+	if (!evicted)
+		clear_search();
+	delete goal;
+	delete start_coord;
 }
\ No newline at end of file
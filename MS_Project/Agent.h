@@ -9,15 +9,15 @@
 
 #include "Macros.h"
 #include "Coordinates.h"
-
-#ifdef TIME_LIMIT
-#include <ctime>
-#endif
+#include "SearchStatus.h"
 
 class AStarNode; 
 class AStarNodeList;
 class World;
-class PathClearAStar;
+class ReservationTable;
+class CancelToken;
+class SolverOptions;
+class LPAStarSearch;
 
 /*
 * Class for performing an A* search based on the world and an
@@ -28,29 +28,72 @@ class Agent
 public:
 
 	/* Initialize the A* search and place the root on the OPEN list */
-#ifdef TIME_LIMIT
 	Agent(
 		Coord* p_start, Coord* p_goal, World* p_world,
-		std::string p_name, std::time_t p_start_time
+		std::string p_name, CancelToken* p_cancel_token = NULL,
+		const SolverOptions* p_options = NULL
 		);
-#else
-	Agent(Coord* p_start, Coord* p_goal, World* p_world, std::string p_name);
-#endif
 	/* Initialize the A* search from a pre-existing agent */
-	Agent(Agent* p_agent, Position* new_constraint);
+	Agent(Agent* p_agent, Position* new_constraints, int num_constraints = 1);
+	/* Initialize from a pre-existing agent whose new solution is already known */
+	Agent(Agent* p_agent, Position* new_constraint, std::stack<Coord>* p_path);
+	/* Initialize from a pre-existing agent with a bounded suboptimal focal search */
+	Agent(Agent* p_agent, Position* new_constraint, double weight, ReservationTable* others);
 
 	/* Add a conflict to the conflict hash table */
 	void add_conflict(Position* conflict);
+	/* Add a positive constraint, the agent must be at the position at its depth */
+	void add_landmark(Position* landmark);
+	/* Check if the agent must be at a position */
+	bool has_landmark(Position* pos);
 	/* Perform the A* search and save the goal node as goal_node */
 	void find_solution();
+	/* Perform the A* search without throwing and return its outcome */
+	SearchStatus solve();
 	/* Return the solution as a stack of coordinates*/
 	std::stack<Coord> get_solution();
+	/* Resume the finished search until every goal arrival at a given depth is known */
+	SearchStatus continue_search(unsigned short cost);
+	/* Get the cells of every path reaching the goal at a given depth, one layer per depth */
+	SearchStatus get_mdd(unsigned short cost, std::vector<std::vector<Coord> >* layers);
+	/* Enumerate up to max_paths paths reaching the goal at a given depth */
+	SearchStatus get_paths(
+		unsigned short cost, unsigned int max_paths, std::vector<std::stack<Coord> >* paths
+		);
 	/* Print the solution to the console */
 	void print_solution();
 	/* Print the solution to a file */
 	void file_print_solution(std::ofstream& file);
 	/* Get the agent's cost */
 	int get_cost();
+	/* Get a lower bound on the agent's optimal cost under its constraints */
+	int get_lower_bound();
+	/* Release the OPEN and CLOSED lists, keeping the path, cost and constraints */
+	void evict();
+	/* Rebuild the OPEN and CLOSED lists of an evicted agent with a new A* search */
+	void restore();
+	/* Check, without searching, that the goal stays reachable under one more constraint */
+	bool can_reach_goal(Position* new_constraint);
+	/* Check, without searching, that the goal stays reachable under several more constraints */
+	bool can_reach_goal(std::vector<Position>* new_constraints);
+	/* Deepest position the search generates, a solution exists above it if one exists at all */
+	unsigned short get_depth_bound();
+
+	/* Number of child agents whose copied lists or LPA* search were repaired since the last reset */
+	static unsigned long get_repair_count() { return repair_count; };
+	/* Number of child agents searched again from the start since the last reset */
+	static unsigned long get_restart_count() { return restart_count; };
+	/* Number of states expanded by the A* and LPA* searches since the last reset */
+	static unsigned long get_expansion_count() { return expansion_count; };
+	/* Count a state expanded by either search */
+	static void count_expansion() { expansion_count++; };
+	/* Count the repair decisions and expansions of one run only */
+	static void reset_search_counts() { repair_count = 0; restart_count = 0; expansion_count = 0; };
+
+	/* Take a reference to the agent for a CBSNode that shares it */
+	void add_ref() { ref_count++; };
+	/* Drop a reference, return true if no CBSNode references the agent anymore */
+	bool release() { return --ref_count == 0; };
 
 	/* Accessor functions */
 	Coord* get_goal() { return goal; };
@@ -62,6 +105,17 @@ public:
 	std::unordered_map<unsigned int, Position>* get_constraints() { return &constraints; };
 	World* get_world() { return world; };
 	std::string get_name() { return name; };
+	bool is_evicted() const { return evicted; };
+	unsigned long long get_constraint_hash() const { return constraint_hash; };
+	unsigned short get_horizon() const { return horizon; };
+	unsigned short get_length_depth() const { return length_depth; };
+	unsigned short get_collapse_depth() const { return collapse_depth; };
+	SearchStatus get_status() const { return status; };
+
+	/* Deadline and cancellation flag of the searches, NULL if they run to completion */
+	CancelToken* get_cancel_token() { return cancel_token; };
+	/* Configuration of the searches */
+	const SolverOptions* get_options() { return options; };
 
 #ifdef OPEN_LIST_DATA
 	/* agent_depth accessor function */
@@ -79,38 +133,107 @@ private:
 	Coord* start_coord;
 	/* Goal node of the search */
 	AStarNode* goal_node;
+	/* Solution path, stored the first time it is traced from the CLOSED list */
+	std::stack<Coord> path;
+	/* True if the OPEN and CLOSED lists were released to save memory */
+	bool evicted;
+	/* Lower bound of a bounded suboptimal solution, -1 if the solution is optimal */
+	int lower_bound;
+	/* Outcome of the last search */
+	SearchStatus status;
 	/* OPEN list in the form of a min heap */
 	std::priority_queue<AStarNode*, std::vector<AStarNode*>, std::greater<AStarNode> > open_list;
 	/* OPEN list in the form of a hash table */
 	AStarNodeList* open_list_hash_table;
 	/* CLOSED list for the search in the form of a hash table */
 	AStarNodeList* closed_list;
+	/* Incremental search used instead of the lists by LPA-CBS, NULL otherwise */
+	LPAStarSearch* lpa_star;
 	/*
 	* Hash table for the conflicts at this node. The key is the cantor pair of the Position
 	* and the value is simply a meaningless boolean value. The value is meaningless because
 	* the only thing that matters is whether or not the Position is in the hash table
 	*/
 	std::unordered_map<unsigned int, Position> constraints;
+	/* Order independent hash of the constraints, updated as constraints are added */
+	unsigned long long constraint_hash;
+	/* Latest depth of any constraint, beyond it time no longer matters */
+	unsigned short horizon;
 	/*
-	* Sub-search to find nodes to remove from the OPEN and CLOSED list
-	* based on a new constraint.
+	* Positive constraints of a disjoint split, each a position the agent must occupy.
+	* They count as constraints for the horizon and the constraint hash.
 	*/
-	PathClearAStar* path_clear;
+	std::vector<Position> landmarks;
+	/* Latest depth of any landmark, the agent only leaves at its goal from then on */
+	unsigned short landmark_depth;
+	/*
+	* Earliest depth the agent may finish at, one past its latest constraint on its goal.
+	* Only set with target reasoning, where a finished agent stays at its goal.
+	*/
+	unsigned short length_depth;
+	/*
+	* Earliest depth beyond the horizon at which each cell is in the OPEN or CLOSED
+	* list, keyed by the coordinate hash. Later states of these cells are duplicates.
+	*/
+	std::unordered_map<unsigned int, unsigned short> collapsed;
+	/* Shallowest depth of a state dropped as a duplicate, USHRT_MAX if none was */
+	unsigned short collapse_depth;
 	/* Calculate the cost of a position */
 	double calc_cost(Position* pos);
 	/* Name of the agent */
 	std::string name;
+	/* Number of CBSNodes holding this agent */
+	int ref_count;
+	/* Child agents repaired with PCA* and searched again since the last reset */
+	static unsigned long repair_count;
+	static unsigned long restart_count;
+	/* States expanded since the last reset */
+	static unsigned long expansion_count;
 
 	/* Get a vector of successor positions of a given position */
 	void get_successors(Position* pos, std::vector<Position>* successors);
+	/* Find the solution with a safe interval search (SIPPSearch) */
+	SearchStatus solve_sipp();
+	/* Find the solution with the incremental LPA* search, keeping only the path */
+	SearchStatus solve_lpa_star();
+	/* Decide if repairing the lists of a pre-existing agent is cheaper than searching again */
+	bool choose_repair(Agent* p_agent, Position* new_constraint);
+	/* Copy everything but the search state from a pre-existing agent */
+	void inherit(Agent* p_agent, Position* new_constraint);
+	/* Create empty OPEN and CLOSED lists and place the start node on the OPEN list */
+	void start_search();
+	/* Delete the OPEN and CLOSED lists and every node they hold */
+	void clear_search();
+	/* Depth bound before it is capped by SEARCH_DEPTH */
+	int sound_depth_bound();
+	/* Check if a position can still be at every later landmark in time */
+	bool reaches_landmarks(Position* pos);
+	/* Check if a position of the search ends the agent's path */
+	bool is_arrival(Position* pos);
+	/* Check if a position is a duplicate of an earlier state beyond the horizon */
+	bool collapse_state(Position* pos);
+	/* Rebuild the earliest depths of the cells beyond the horizon from the lists */
+	void index_collapsed();
+	/* Generate the dropped successors of copied CLOSED nodes that are no longer duplicates */
+	void repair_collapsed(bool collapse);
+	/* Find the node of a state on a path to a goal arrival */
+	AStarNode* get_arrival_node(Position* pos);
 
 #ifdef OPEN_LIST_DATA
 	/* Agent's depth  (i.e. number of ancestor agents) */
 	int agent_depth;
 #endif
-#ifdef TIME_LIMIT
-	std::time_t start_time;
-#endif
+	/* Deadline and cancellation flag shared with the CBSTree, not owned by the agent */
+	CancelToken* cancel_token;
+	/* Configuration shared with the CBSTree, not owned by the agent */
+	const SolverOptions* options;
+
+	/* Expand nodes until the goal is popped, with the configuration compiled into the loop */
+	template <bool CLASSIC, bool COLLAPSE>
+	SearchStatus expand_nodes();
+	/* Generate the successors of a node and move it to the CLOSED list */
+	template <bool COLLAPSE>
+	int expand_node(AStarNode* top);
 };
 
 #endif
\ No newline at end of file
@@ -1,8 +1,13 @@
 #include "CBSNode.h"
 #include "Agent.h"
 #include "Coordinates.h"
+#include "ConflictMatrix.h"
 #include "HashStruct.h"
 #include "Exceptions.h"
+#include "PathCache.h"
+#include "ReservationTable.h"
+#include "SolverOptions.h"
+#include "World.h"
 
 /* 
 * Constructor for the first node in the CBSTree
@@ -17,16 +22,34 @@ CBSNode::CBSNode(std::vector<Agent*>* p_agents)
 
 	/* No agents generated by this node (they are the responsibility of the calling CBSTree */
 	new_agent_num = -1;
+	owned = std::vector<bool>(agents.size(), false);
 	
 	/* Get solution and cost for all agents	*/
 	cost = 0;
+	lower_bound = 0;
+	num_conflicts = -1;
+	conflict_matrix = NULL;
+	hash = 0;
+	status = SEARCH_SOLVED;
 	int agent_cost;
 	int num_agents = agents.size();
 	for (int i = 0; i < num_agents; i++)
 	{
+		/* The root fails with its first agent that has no solution */
+		SearchStatus agent_status = agents[i]->solve();
+		if (agent_status != SEARCH_SOLVED)
+		{
+			status = agent_status;
+			return;
+		}
 		agent_cost = agents[i]->get_cost();
 		if (agent_cost > cost)
 			cost = agent_cost;
+		if (agents[i]->get_lower_bound() > lower_bound)
+			lower_bound = agents[i]->get_lower_bound();
+
+		/* Combine the agent's constraint set into the node's hash */
+		hash ^= HashStruct::hash_agent_constraints(i, agents[i]->get_constraint_hash());
 	}
 }
 
@@ -36,151 +59,486 @@ CBSNode::CBSNode(std::vector<Agent*>* p_agents)
 * @param agent_num: The number of the agent who will have a conflict added
 * to its list of conflicts
 * @param conflict: The conflict to add to a single agent (agent_num)
+* @param cache: Low level results shared across the CBSTree, NULL to always search
+* @param positive_num: The agent that must be at the conflict instead (the positive child
+* of a disjoint split), -1 if only agent_num is constrained
+*/
+CBSNode::CBSNode(
+	CBSNode* parent_node, int agent_num, Position* conflict, PathCache* cache, int positive_num
+	)
+{
+	/* Set the list of agents to point to the parent's list of agents */
+	agents = *parent_node->get_agents();
+	owned = *parent_node->get_owned();
+
+	/* Only the constrained agents' constraint sets change */
+	hash = child_hash(parent_node, agent_num, conflict, positive_num);
+	num_conflicts = -1;
+	conflict_matrix = NULL;
+	status = SEARCH_SOLVED;
+
+	/* Constrain and search the agent, nothing is shared yet if it has no solution */
+	if (!constrain_agent(parent_node, agent_num, conflict, 1, cache))
+		return;
+
+	/*
+	* The path of the positive agent passes through the conflict, so it stays optimal
+	* under the landmark and is kept without searching. Its children search from the start.
+	*/
+	if (positive_num != -1)
+	{
+		std::stack<Coord> path = agents[positive_num]->get_solution();
+		Agent* positive_agent = new Agent(agents[positive_num], NULL, &path);
+		positive_agent->add_landmark(conflict);
+		agents[positive_num] = positive_agent;
+	}
+	share_agents(agent_num, positive_num);
+	inherit_conflicts(parent_node, agent_num, positive_num);
+}
+
+/*
+* Constructor for non-root nodes whose agent receives several constraints at once,
+* e.g. the range of constraints resolving a corridor conflict
+* @param parent_node: CBSNode to base this CBSNode on
+* @param agent_num: The number of the agent who will have the constraints added
+* @param constraints: The constraints to add, none of them already held by the agent
+* @param cache: Low level results shared across the CBSTree, NULL to always search
 */
-CBSNode::CBSNode(CBSNode* parent_node, int agent_num, Position* conflict)
+CBSNode::CBSNode(
+	CBSNode* parent_node, int agent_num, std::vector<Position>* constraints, PathCache* cache
+	)
 {
 	/* Set the list of agents to point to the parent's list of agents */
 	agents = *parent_node->get_agents();
+	owned = *parent_node->get_owned();
 
-	/* Create a new agent with a new conflict */
-	Agent* updated_agent = new Agent(agents[agent_num], conflict);
+	/* Only the constrained agent's constraint set changes */
+	hash = child_hash(parent_node, agent_num, constraints);
+	num_conflicts = -1;
+	conflict_matrix = NULL;
+	status = SEARCH_SOLVED;
+
+	if (constrain_agent(parent_node, agent_num, &(*constraints)[0], constraints->size(), cache))
+	{
+		share_agents(agent_num);
+		inherit_conflicts(parent_node, agent_num);
+	}
+}
+
+/*
+* Replace an agent of the parent node with a child agent under new constraints
+* and find its solution, reusing a cached one if the tree has it. The node's
+* cost is set from the parent's cost and the new agent's.
+* @param parent_node: CBSNode this CBSNode is based on
+* @param agent_num: The number of the agent to constrain
+* @param constraints: The new constraints of the agent
+* @param num_constraints: Number of constraints in constraints
+* @param cache: Low level results shared across the CBSTree, NULL to always search
+* @return true if the agent has a solution, false if the node failed
+*/
+bool CBSNode::constrain_agent(
+	CBSNode* parent_node, int agent_num, Position* constraints, int num_constraints, PathCache* cache
+	)
+{
+	/* Look for the agent's result under the new constraint set */
+	unsigned long long constraint_hash = agents[agent_num]->get_constraint_hash();
+	for (int i = 0; i < num_constraints; i++)
+		constraint_hash ^= HashStruct::hash_constraint(&constraints[i]);
+	CachedPath* cached = NULL;
+	if (cache != NULL)
+		cached = cache->find(agent_num, constraint_hash);
+
+	/* The agent is known to have no solution under these constraints */
+	if (cached != NULL && !cached->is_feasible())
+	{
+		fail(SEARCH_INFEASIBLE);
+		return false;
+	}
+
+	/* Create a new agent with the new constraints, reusing a known solution */
+	Agent* updated_agent;
+	if (cached != NULL)
+	{
+		updated_agent = new Agent(agents[agent_num], constraints, cached->get_path());
+		for (int i = 1; i < num_constraints; i++)
+			updated_agent->add_conflict(&constraints[i]);
+	}
+	else
+		updated_agent = new Agent(agents[agent_num], constraints, num_constraints);
+
+	/* Find the new agent's solution, the agent is not shared yet if no solution exists */
+	SearchStatus agent_status = updated_agent->solve();
+	if (agent_status != SEARCH_SOLVED)
+	{
+		/* A timed out search says nothing about the constraints */
+		if (cache != NULL && agent_status != SEARCH_TIMEOUT)
+			cache->insert(agent_num, constraint_hash, NULL);
+		delete updated_agent;
+		fail(agent_status);
+		return false;
+	}
+	int agent_cost = updated_agent->get_cost();
+
+	/* Share the new result with the rest of the tree */
+	if (cache != NULL && cached == NULL)
+	{
+		std::stack<Coord> path = updated_agent->get_solution();
+		cache->insert(agent_num, constraint_hash, &path);
+	}
 
 	/* Replace the specified agent in agents with the newly created agent */
 	agents[agent_num] = updated_agent;
 
-	/* Store the index of the new agent generated in this node */
-	new_agent_num = agent_num;
-
 	/* Update the cost if this agent's cost is greater than that of the node */
 	cost = parent_node->get_cost();
-	int agent_cost = agents[agent_num]->get_cost();
 	if (agent_cost > cost)
 		cost = agent_cost;
+	lower_bound = cost;
+	return true;
 }
 
-/* 
-* Find one (or two) conflict positions between two agents 
-* @param agent_1: Will be set to an agent num for a conflict agent
-* @param conflict_1: Conflict position for agent 1
-* @param agent_2: Will be set to an agent num for a conflict agent
-* @param conflict_2: Conflict position for agent 2
-* @return true if a conflict is found, false otherwise
+/*
+* Constructor for non-root nodes of a bounded suboptimal (ECBS) tree. The agent
+* is planned by a focal search that avoids the paths of the other agents.
+* @param parent_node: CBSNode to base this CBSNode on
+* @param agent_num: The number of the agent who will have a conflict added
+* to its list of conflicts
+* @param conflict: The conflict to add to a single agent (agent_num)
+* @param weight: Suboptimality factor of the agent's focal search
 */
-bool CBSNode::get_conflicts(int* agent_1, Position* conflict_1, int* agent_2, Position* conflict_2)
+CBSNode::CBSNode(CBSNode* parent_node, int agent_num, Position* conflict, double weight)
 {
-	/* Current and previous coordinates in the path */
-	Coord curr_coord;
-	Coord prev_coord;
+	/* Set the list of agents to point to the parent's list of agents */
+	agents = *parent_node->get_agents();
+	owned = *parent_node->get_owned();
+	hash = child_hash(parent_node, agent_num, conflict);
+	num_conflicts = -1;
+	conflict_matrix = NULL;
+	status = SEARCH_SOLVED;
+
+	/* Reserve the paths of every other agent */
+	ReservationTable others = ReservationTable();
+	int num_agents = agents.size();
+	for (int i = 0; i < num_agents; i++)
+	{
+		if (i != agent_num)
+			others.add_path(agents[i]->get_solution());
+	}
 
-	/* Depth of the search */
-	int depth = 0;
+	/* Plan the agent, nothing is shared yet if it has no solution */
+	Agent* updated_agent = new Agent(agents[agent_num], conflict, weight, &others);
+	if (updated_agent->get_status() != SEARCH_SOLVED)
+	{
+		SearchStatus agent_status = updated_agent->get_status();
+		delete updated_agent;
+		fail(agent_status);
+		return;
+	}
+	agents[agent_num] = updated_agent;
+	share_agents(agent_num);
+	inherit_conflicts(parent_node, agent_num);
 
-	/* Hash table of agent numbers based on a coordinate and depth */
-	std::unordered_multimap<unsigned int, AgentPos*> occupied_coords =
-		std::unordered_multimap<unsigned int, AgentPos*>();
+	/* The cost and lower bound are the largest of any agent */
+	cost = 0;
+	lower_bound = 0;
+	for (int i = 0; i < num_agents; i++)
+	{
+		if (agents[i]->get_cost() > cost)
+			cost = agents[i]->get_cost();
+		if (agents[i]->get_lower_bound() > lower_bound)
+			lower_bound = agents[i]->get_lower_bound();
+	}
+	count_conflicts();
+}
 
-	/* Path of an individual agent */
-	std::stack<Coord> path;
+/*
+* Give up a child node whose agent has no solution. The agents copied from the
+* parent node are not shared, so deleting the node releases nothing.
+* @param p_status: Outcome of the agent's low level search
+*/
+void CBSNode::fail(SearchStatus p_status)
+{
+	owned.assign(owned.size(), false);
+	new_agent_num = -1;
+	cost = 0;
+	lower_bound = 0;
+	status = p_status;
+}
 
-	/* Iterate through the path of each agent */
+/*
+* Share the agents copied from the parent node, once the new agents replaced
+* the parent's agents at agent_num (and positive_num)
+* @param agent_num: The number of the agent generated by this node
+* @param positive_num: The number of the agent given a landmark by this node, -1 if none
+*/
+void CBSNode::share_agents(int agent_num, int positive_num)
+{
+	owned[agent_num] = true;
+
+	/* Share the remaining agents generated by ancestor nodes */
 	int num_agents = agents.size();
 	for (int i = 0; i < num_agents; i++)
 	{
-		/* Get the path of the agent */
-		path = agents[i]->get_solution();
+		if (i != agent_num && i != positive_num && owned[i])
+			agents[i]->add_ref();
+	}
+	if (positive_num != -1)
+		owned[positive_num] = true;
 
-		/* Initialize the depth */
-		depth = 0;
+	/* Store the index of the new agent generated in this node */
+	new_agent_num = agent_num;
+}
 
-		/* Get the start coordinate */
-		prev_coord = path.top();
-		path.pop();
+/*
+* Copy the conflicts of the parent node if it checked them. The paths of the
+* agents shared with the parent did not change, so only the rows of the agents
+* replaced by this node are stale.
+* @param parent_node: The CBSNode this CBSNode is based on
+* @param agent_num: The number of the agent generated by this node
+* @param positive_num: The number of the agent given a landmark by this node, -1 if none
+*/
+void CBSNode::inherit_conflicts(CBSNode* parent_node, int agent_num, int positive_num)
+{
+	if (parent_node->get_conflict_matrix() == NULL)
+		return;
 
-		/*
-		* Iterate through each coordinate in the path except
-		* the first coordinate because it is assumed the starting
-		* coordinate of each agent is unique
-		*/
+	conflict_matrix = new ConflictMatrix(*parent_node->get_conflict_matrix());
+	conflict_matrix->mark_stale(agent_num);
+	if (positive_num != -1)
+		conflict_matrix->mark_stale(positive_num);
+}
+
+/*
+* Count the conflicts between every pair of agents
+*/
+void CBSNode::count_conflicts()
+{
+	std::vector<std::vector<Coord> > paths;
+	update_conflicts(&paths);
+	num_conflicts = conflict_matrix == NULL ? 0 : conflict_matrix->get_total();
+}
+
+/*
+* Get the paths of the agents and check the rows of the conflict matrix of the
+* agents replaced since the conflicts were last checked. With target reasoning a
+* finished agent stays at its goal until the last agent finishes.
+* @param paths: Filled with the paths of the agents, indexed by depth
+*/
+void CBSNode::update_conflicts(std::vector<std::vector<Coord> >* paths)
+{
+	int num_agents = agents.size();
+	*paths = std::vector<std::vector<Coord> >(num_agents);
+	for (int i = 0; i < num_agents; i++)
+	{
+		std::stack<Coord> path = agents[i]->get_solution();
+		(*paths)[i].reserve(path.size());
 		while (!path.empty())
 		{
-			/* Get the next coordinate in the path */
-			curr_coord = path.top();
+			(*paths)[i].push_back(path.top());
 			path.pop();
-			depth++;
-
-			/* Create a position based on the coordinate and depth */
-			Position curr_pos = Position(curr_coord, depth);
-
-			/* Check if that coordinate is already occupied at that depth */
-			auto it = find_it(&curr_pos, &occupied_coords);
-			if (it != occupied_coords.end())
-			{
-				*agent_1 = i;
-				*agent_2 = it->second->get_agent_num();
-
-				/* Set agent 1's conflict */
-				conflict_1->set_x(curr_coord.get_xcoord());
-				conflict_1->set_y(curr_coord.get_ycoord());
-				conflict_1->set_depth(depth);
-
-				/* Agent 2 has the same conflict as agent 1*/
-				*conflict_2 = *conflict_1;
-
-				cleanup_occ_coords(&occupied_coords);
-				return true;
-			}
-
-			/* Check if there is a 'swap' conflict */
-			Position swap_curr_pos = Position(prev_coord, depth);
-			Position swap_prev_pos = Position(curr_coord, depth - 1);
-			
-			auto swap_curr_it = find_it(&swap_curr_pos, &occupied_coords);
-			auto swap_prev_it = find_it(&swap_prev_pos, &occupied_coords);
-			if (
-				swap_curr_it != occupied_coords.end() &&
-				swap_prev_it != occupied_coords.end() &&
-				swap_curr_it->second->get_agent_num() == swap_prev_it->second->get_agent_num()
-				)
-			{
-				*agent_1 = i;
-				*agent_2 = swap_curr_it->second->get_agent_num();
-
-				/* Set agent 1's conflict */
-				conflict_1->set_x(curr_coord.get_xcoord());
-				conflict_1->set_y(curr_coord.get_ycoord());
-				conflict_1->set_depth(depth);
-
-				/* Set agent 2's conflict */
-				conflict_2->set_x(prev_coord.get_xcoord());
-				conflict_2->set_y(prev_coord.get_ycoord());
-				conflict_2->set_depth(depth);
-				cleanup_occ_coords(&occupied_coords);
-				return true;
-			}
-
-			/* No conflict, add this coordinate and depth to the hash table */
-			AgentPos* add_pos = new AgentPos(i,&curr_pos);
-			occupied_coords.emplace(HashStruct::hash_pos(&curr_pos), add_pos);
-
-			/* Set the previous coord and hash to the current coord and hash */
-			prev_coord = curr_coord;
 		}
 	}
-	/* No conflict was found */
-	cleanup_occ_coords(&occupied_coords);
-	return false;
+	if (num_agents == 0)
+		return;
+
+	if (conflict_matrix == NULL)
+		conflict_matrix = new ConflictMatrix(num_agents);
+	conflict_matrix->update(
+		agents[0]->get_world(), paths, agents[0]->get_options()->target_reasoning
+		);
 }
 
 /* 
-* Cleanup occupied coords hash table 
-* @param occupied_coords: Hash table to delete each AgentPos from
+* Find one (or two) conflict positions between two agents. With target reasoning a
+* finished agent stays at its goal until the last agent finishes, so an agent at the
+* goal of a finished agent is in a target conflict with it. The constraint on the
+* finished agent is then on its own goal, a length constraint.
+* @param agent_1: Will be set to an agent num for a conflict agent
+* @param conflict_1: Conflict position for agent 1
+* @param agent_2: Will be set to an agent num for a conflict agent
+* @param conflict_2: Conflict position for agent 2
+* @return true if a conflict is found, false otherwise
 */
-void CBSNode::cleanup_occ_coords(
-	std::unordered_multimap<unsigned int, AgentPos*>* occupied_coords
+bool CBSNode::get_conflicts(int* agent_1, Position* conflict_1, int* agent_2, Position* conflict_2)
+{
+	/* Paths of the agents, indexed by depth */
+	std::vector<std::vector<Coord> > paths;
+	update_conflicts(&paths);
+	if (conflict_matrix == NULL || !conflict_matrix->get_first_conflict(agent_1, agent_2))
+		return false;
+
+	/* Set agent 1's conflict */
+	int depth = conflict_matrix->get_depth(*agent_1, *agent_2);
+	Coord* curr_coord = ConflictMatrix::path_coord(&paths[*agent_1], depth, true);
+	conflict_1->set_x(curr_coord->get_xcoord());
+	conflict_1->set_y(curr_coord->get_ycoord());
+	conflict_1->set_depth(depth);
+
+	/* Agent 2 has the same conflict as agent 1, unless they swap cells */
+	*conflict_2 = *conflict_1;
+	if (conflict_matrix->get_type(*agent_1, *agent_2) == CONFLICT_SWAP)
+	{
+		Coord* prev_coord = ConflictMatrix::path_coord(&paths[*agent_1], depth - 1, true);
+		conflict_2->set_x(prev_coord->get_xcoord());
+		conflict_2->set_y(prev_coord->get_ycoord());
+	}
+	return true;
+}
+
+/*
+* Find one conflict between two agents and the constraints resolving it. A vertex
+* or swap conflict is resolved by one constraint on each agent. Two agents crossing
+* a corridor in opposite directions conflict again at every depth one of them waits
+* for, so a conflict inside a corridor is resolved by ranges of constraints instead.
+* @param agent_1: Will be set to an agent num for a conflict agent
+* @param constraints_1: Filled with the constraints of agent 1
+* @param agent_2: Will be set to an agent num for a conflict agent
+* @param constraints_2: Filled with the constraints of agent 2
+* @param corridors: True to resolve conflicts inside corridors with ranges of constraints
+* @return true if a conflict is found, false otherwise
+*/
+bool CBSNode::get_conflicts(
+	int* agent_1, std::vector<Position>* constraints_1,
+	int* agent_2, std::vector<Position>* constraints_2, bool corridors
 	)
 {
-	for (auto it = occupied_coords->begin(); it != occupied_coords->end(); it++)
-		delete it->second;
+	Position conflict_1 = Position();
+	Position conflict_2 = Position();
+	if (!get_conflicts(agent_1, &conflict_1, agent_2, &conflict_2))
+		return false;
+
+	constraints_1->clear();
+	constraints_2->clear();
+	if (corridors && get_corridor_constraints(
+		*agent_1, &conflict_1, *agent_2, &conflict_2, constraints_1, constraints_2
+		))
+		return true;
+
+	constraints_1->push_back(conflict_1);
+	constraints_2->push_back(conflict_2);
+	return true;
+}
+
+/*
+* Get the ranges of constraints resolving a conflict of two agents crossing a corridor
+* in opposite directions. Each corridor cell has two open neighbors, so inside it the
+* agents cannot pass each other and one of them must leave the corridor before the other
+* enters it. If agent 1 moves from end_1 to end_2 over a corridor of length k, either
+* agent 1 first reaches end_2 after agent 2 could reach end_1 plus k, or agent 2 first
+* reaches end_1 after agent 1 could reach end_2 plus k. Each child keeps one agent from
+* its exit until then, unless it could get there sooner by a path avoiding the corridor.
+* Distances ignore constraints, so the ranges never cut off a solution. Rectangle
+* reasoning does not apply to this world: agents moving diagonally cross without a conflict.
+* @param agent_1: The number of the first agent of the conflict
+* @param conflict_1: Conflict position for agent 1
+* @param agent_2: The number of the second agent of the conflict
+* @param conflict_2: Conflict position for agent 2
+* @param constraints_1: Filled with the range of constraints of agent 1
+* @param constraints_2: Filled with the range of constraints of agent 2
+* @return true if the conflict is inside a corridor both agents cross, false otherwise
+*/
+bool CBSNode::get_corridor_constraints(
+	int agent_1, Position* conflict_1, int agent_2, Position* conflict_2,
+	std::vector<Position>* constraints_1, std::vector<Position>* constraints_2
+	)
+{
+	/* The corridor through either cell of the conflict */
+	World* world = agents[agent_1]->get_world();
+	std::vector<Coord> corridor = std::vector<Coord>();
+	if (!world->get_corridor(conflict_1->get_coord(), &corridor) &&
+		!world->get_corridor(conflict_2->get_coord(), &corridor))
+		return false;
+	int length = corridor.size() - 1;
+	std::vector<Coord> inside = std::vector<Coord>(corridor.begin() + 1, corridor.end() - 1);
+
+	/* Agent 1 must cross from end_1 to end_2 and agent 2 from end_2 to end_1 */
+	Coord end_1 = corridor.front();
+	Coord end_2 = corridor.back();
+	int enter_1, exit_1, enter_2, exit_2;
+	first_visits(agent_1, &end_1, &end_2, &enter_1, &exit_1);
+	first_visits(agent_2, &end_2, &end_1, &enter_2, &exit_2);
+	if (enter_1 == -1 || exit_1 == -1 || enter_2 == -1 || exit_2 == -1 ||
+		enter_1 > exit_1 || enter_2 > exit_2)
+	{
+		/* Try the agents the other way around */
+		Coord swap = end_1;
+		end_1 = end_2;
+		end_2 = swap;
+		first_visits(agent_1, &end_1, &end_2, &enter_1, &exit_1);
+		first_visits(agent_2, &end_2, &end_1, &enter_2, &exit_2);
+		if (enter_1 == -1 || exit_1 == -1 || enter_2 == -1 || exit_2 == -1 ||
+			enter_1 > exit_1 || enter_2 > exit_2)
+			return false;
+	}
+
+	/* An agent starting inside the corridor may leave it either way */
+	for (unsigned int i = 0; i < inside.size(); i++)
+	{
+		if (inside[i] == *agents[agent_1]->get_start() || inside[i] == *agents[agent_2]->get_start())
+			return false;
+	}
+
+	/* Latest depth each agent is kept from its exit */
+	Coord* start_1 = agents[agent_1]->get_start();
+	Coord* start_2 = agents[agent_2]->get_start();
+	int last_1 = world->get_distance(start_2, &end_1) + length;
+	int bypass_1 = world->get_distance(start_1, &end_2, &inside);
+	if (bypass_1 != -1 && bypass_1 - 1 < last_1)
+		last_1 = bypass_1 - 1;
+	int last_2 = world->get_distance(start_1, &end_2) + length;
+	int bypass_2 = world->get_distance(start_2, &end_1, &inside);
+	if (bypass_2 != -1 && bypass_2 - 1 < last_2)
+		last_2 = bypass_2 - 1;
+
+	/* Both paths must break their range, or a child would keep its parent's paths */
+	if (exit_1 > last_1 || exit_2 > last_2)
+		return false;
+
+	add_range(agent_1, &end_2, last_1, constraints_1);
+	add_range(agent_2, &end_1, last_2, constraints_2);
+	return true;
+}
+
+/*
+* Add the constraints keeping an agent from a coordinate from depth 1 up to a depth,
+* except those the agent already has
+* @param agent_num: The number of the agent
+* @param coord: The coordinate the agent is kept from
+* @param last_depth: The deepest constraint of the range
+* @param constraints: Vector the constraints are appended to
+*/
+void CBSNode::add_range(int agent_num, Coord* coord, int last_depth, std::vector<Position>* constraints)
+{
+	std::unordered_map<unsigned int, Position>* held = agents[agent_num]->get_constraints();
+	for (int depth = 1; depth <= last_depth; depth++)
+	{
+		Position constraint = Position(*coord, depth);
+		if (held->find(HashStruct::hash_pos(&constraint)) == held->end())
+			constraints->push_back(constraint);
+	}
+}
+
+/*
+* Get the depths an agent first reaches two coordinates at on its path
+* @param agent_num: The number of the agent
+* @param coord_1: The first coordinate
+* @param coord_2: The second coordinate
+* @param depth_1: Set to the first depth at coord_1, -1 if the path never reaches it
+* @param depth_2: Set to the first depth at coord_2, -1 if the path never reaches it
+*/
+void CBSNode::first_visits(int agent_num, Coord* coord_1, Coord* coord_2, int* depth_1, int* depth_2)
+{
+	*depth_1 = -1;
+	*depth_2 = -1;
+	std::stack<Coord> path = agents[agent_num]->get_solution();
+	for (int depth = 0; !path.empty(); depth++)
+	{
+		if (*depth_1 == -1 && path.top() == *coord_1)
+			*depth_1 = depth;
+		if (*depth_2 == -1 && path.top() == *coord_2)
+			*depth_2 = depth;
+		path.pop();
+	}
 }
 
 /* 
@@ -190,9 +548,27 @@ void CBSNode::cleanup_occ_coords(
 */
 CBSNode & CBSNode::operator=(CBSNode& rhs)
 {
+	/* Share the agents of rhs, releasing the ones held before */
+	int num_agents = rhs.get_agents()->size();
+	for (int i = 0; i < num_agents; i++)
+	{
+		if ((*rhs.get_owned())[i])
+			(*rhs.get_agents())[i]->add_ref();
+	}
+	release_agents();
+
 	/* Copy CBSNode data by value */
 	agents = *rhs.get_agents();
+	owned = *rhs.get_owned();
 	cost = rhs.get_cost();
+	lower_bound = rhs.get_lower_bound();
+	num_conflicts = rhs.get_num_conflicts();
+	status = rhs.get_status();
+	hash = rhs.get_hash();
+	delete conflict_matrix;
+	conflict_matrix = NULL;
+	if (rhs.get_conflict_matrix() != NULL)
+		conflict_matrix = new ConflictMatrix(*rhs.get_conflict_matrix());
 
 	/* No new nodes generated in this node */
 	new_agent_num = -1;
@@ -200,35 +576,58 @@ CBSNode & CBSNode::operator=(CBSNode& rhs)
 	return rhs;
 }
 
-/* Find a position in a hash table that allows some duplicates */
-std::unordered_multimap<unsigned int, AgentPos*>::iterator CBSNode::find_it(
-	Position* pos, std::unordered_multimap<unsigned int, AgentPos*>* map
+/*
+* Hash of the child CBSNode that would add a conflict to one agent. This is
+* computed from the parent's hash without generating the child's agent.
+* @param parent_node: The CBSNode the child is based on
+* @param agent_num: The number of the agent who would receive the conflict
+* @param conflict: The conflict to add
+* @param positive_num: The number of the agent who would receive the conflict as a
+* landmark, -1 if none
+* @return the hash the child CBSNode would have
+*/
+unsigned long long CBSNode::child_hash(
+	CBSNode* parent_node, int agent_num, Position* conflict, int positive_num
 	)
 {
-	/* Find the first iterator pointing to a key of pos */
-	std::unordered_multimap<unsigned int, AgentPos*>::iterator it =
-		map->find(HashStruct::hash_pos(pos));
-
-	/* If no node contains this key, return a NULL pointer */
-	if (it == map->end())
-		return map->end();
-
-	/* Store the key of the iterator */
-	unsigned int hash_val = HashStruct::hash_pos(pos);
-
-	/* Check all elements with this key */
-	while (it->first == hash_val)
-	{
-		/* Compare coordinates and depth */
-		if (*pos == *it->second->get_pos())
-			return it;
-
-		/* Move to the next element */
-		it++;
-	}
+	/* The agent's constraint set before and after adding the conflict */
+	unsigned long long old_set = (*parent_node->get_agents())[agent_num]->get_constraint_hash();
+	unsigned long long new_set = old_set ^ HashStruct::hash_constraint(conflict);
+
+	/* Swap the agent's old constraint set for the new one */
+	unsigned long long hash = parent_node->get_hash() ^
+		HashStruct::hash_agent_constraints(agent_num, old_set) ^
+		HashStruct::hash_agent_constraints(agent_num, new_set);
+	if (positive_num == -1)
+		return hash;
+
+	/* Likewise for the positive agent's landmark */
+	old_set = (*parent_node->get_agents())[positive_num]->get_constraint_hash();
+	new_set = old_set ^ HashStruct::hash_landmark(conflict);
+	return hash ^
+		HashStruct::hash_agent_constraints(positive_num, old_set) ^
+		HashStruct::hash_agent_constraints(positive_num, new_set);
+}
 
-	/* The exact node could not be found */
-	return map->end();
+/*
+* Hash of the child CBSNode that would add several constraints to one agent
+* @param parent_node: The CBSNode the child is based on
+* @param agent_num: The number of the agent who would receive the constraints
+* @param constraints: The constraints to add, none of them already held by the agent
+* @return the hash the child CBSNode would have
+*/
+unsigned long long CBSNode::child_hash(
+	CBSNode* parent_node, int agent_num, std::vector<Position>* constraints
+	)
+{
+	unsigned long long old_set = (*parent_node->get_agents())[agent_num]->get_constraint_hash();
+	unsigned long long new_set = old_set;
+	for (unsigned int i = 0; i < constraints->size(); i++)
+		new_set ^= HashStruct::hash_constraint(&(*constraints)[i]);
+
+	return parent_node->get_hash() ^
+		HashStruct::hash_agent_constraints(agent_num, old_set) ^
+		HashStruct::hash_agent_constraints(agent_num, new_set);
 }
 
 /*
@@ -240,15 +639,25 @@ void CBSNode::print_solution()
 		agents[i]->print_solution();
 }
 
+/*
+* Release every agent this node holds a reference to. An agent is deleted
+* once no node holds it anymore (i.e. all of its descendants are gone).
+*/
+void CBSNode::release_agents()
+{
+	int num_agents = agents.size();
+	for (int i = 0; i < num_agents; i++)
+	{
+		if (owned[i] && agents[i]->release())
+			delete agents[i];
+	}
+}
+
 /* 
 * Destructor 
 */
 CBSNode::~CBSNode()
 {
-	/* 
-	* Delete the new agent generated in this node. The new_agent_num is -1
-	* if no new agent was generated in this node 
-	*/
-	if (new_agent_num != -1)
-		delete agents[new_agent_num];
+	release_agents();
+	delete conflict_matrix;
 }
\ No newline at end of file
@@ -2,26 +2,46 @@
 #define CBSNODE_H
 
 #include <vector>
-#include <unordered_map>
+#include <cstddef>
+
+#include "SearchStatus.h"
 
 class Agent;
+class Coord;
 class Position;
-class AgentPos;
+class PathCache;
+class ConflictMatrix;
 
 class CBSNode
 {
 public:
 	/* Constructors */
 	CBSNode(std::vector<Agent*>* p_agents);
-	CBSNode(CBSNode* parent_node, int agent_num, Position* conflict);
+	CBSNode(
+		CBSNode* parent_node, int agent_num, Position* conflict, PathCache* cache = NULL,
+		int positive_num = -1
+		);
+	CBSNode(CBSNode* parent_node, int agent_num, std::vector<Position>* constraints, PathCache* cache);
+	CBSNode(CBSNode* parent_node, int agent_num, Position* conflict, double weight);
 
 	/* Find one (or two) conflict positions between two agents */
 	bool get_conflicts(int* agent_1, Position* conflict_1, int* agent_2, Position* conflict_2);
-	/* Find a position in a hash table that allows some duplicates */
-	std::unordered_multimap<unsigned int, AgentPos*>::iterator
-		find_it(Position* pos, std::unordered_multimap<unsigned int, AgentPos*>* map);
+	/* Find a conflict and the constraints resolving it, ranges of constraints for a corridor conflict */
+	bool get_conflicts(
+		int* agent_1, std::vector<Position>* constraints_1,
+		int* agent_2, std::vector<Position>* constraints_2, bool corridors
+		);
+	/* Count the conflicts between every pair of agents */
+	void count_conflicts();
 	/* Print the solution to the console */
 	void print_solution();
+	/* Hash of the child CBSNode that would add a conflict to one agent (and a landmark to another) */
+	static unsigned long long child_hash(
+		CBSNode* parent_node, int agent_num, Position* conflict, int positive_num = -1
+		);
+	static unsigned long long child_hash(
+		CBSNode* parent_node, int agent_num, std::vector<Position>* constraints
+		);
 
 	/* Operators */
 	CBSNode & operator=(CBSNode& rhs);
@@ -29,21 +49,68 @@ public:
 	/* Accessors */
 	int get_num_agents() const { return agents.size(); };
 	int get_cost() const { return cost; };
+	int get_lower_bound() const { return lower_bound; };
+	int get_num_conflicts() const { return num_conflicts; };
+	unsigned long long get_hash() const { return hash; };
 	std::vector<Agent*>* get_agents() { return &agents; };
+	std::vector<bool>* get_owned() { return &owned; };
+	ConflictMatrix* get_conflict_matrix() { return conflict_matrix; };
+	SearchStatus get_status() const { return status; };
 
 	/* Destructor */
 	~CBSNode();
 private:
 	/* Vector of pointers to agents */
 	std::vector<Agent*> agents;
+	/*
+	* True if this node holds a reference to the agent at the same index.
+	* Agents generated by CBSNodes are shared between a node and its descendants
+	* and deleted by the last node to release them. Root agents belong to the caller.
+	*/
+	std::vector<bool> owned;
 	/* Vector of agent numbers generated for this node */
 	int new_agent_num;
 	/* Cost of the node */
 	int cost;
-	/* Cleanup occupied coords hash table */
-	void cleanup_occ_coords(
-		std::unordered_multimap<unsigned int, AgentPos*>* occupied_coords
+	/* Lower bound on the cost of the node's constraints, equal to cost unless agents are suboptimal */
+	int lower_bound;
+	/* Number of conflicts between the agents, -1 until they are counted */
+	int num_conflicts;
+	/* Hash of every agent's constraint set, equal for nodes with equal constraints */
+	unsigned long long hash;
+	/*
+	* Outcome of the low level searches, a node whose status is not SEARCH_SOLVED
+	* holds no agents and must not be expanded
+	*/
+	SearchStatus status;
+	/*
+	* Conflicts between every pair of agents, NULL until get_conflicts checks them.
+	* Copied from the parent node with only the new agents' rows checked again.
+	*/
+	ConflictMatrix* conflict_matrix;
+	/* Give up the node, none of the parent's agents are shared */
+	void fail(SearchStatus p_status);
+	/* Replace an agent with a child under new constraints and search it, false if the node failed */
+	bool constrain_agent(
+		CBSNode* parent_node, int agent_num, Position* constraints, int num_constraints, PathCache* cache
+		);
+	/* Get the ranges of constraints resolving a conflict of two agents crossing a corridor */
+	bool get_corridor_constraints(
+		int agent_1, Position* conflict_1, int agent_2, Position* conflict_2,
+		std::vector<Position>* constraints_1, std::vector<Position>* constraints_2
 		);
+	/* Add the constraints keeping an agent from a coordinate up to a depth */
+	void add_range(int agent_num, Coord* coord, int last_depth, std::vector<Position>* constraints);
+	/* Depths an agent first reaches two coordinates at, -1 for a coordinate it never reaches */
+	void first_visits(int agent_num, Coord* coord_1, Coord* coord_2, int* depth_1, int* depth_2);
+	/* Share the agents of the parent node except the replaced ones */
+	void share_agents(int agent_num, int positive_num = -1);
+	/* Copy the conflicts of the parent node, the replaced agents are checked again */
+	void inherit_conflicts(CBSNode* parent_node, int agent_num, int positive_num = -1);
+	/* Get the paths of the agents and check the stale rows of the conflict matrix */
+	void update_conflicts(std::vector<std::vector<Coord> >* paths);
+	/* Release every agent this node holds a reference to */
+	void release_agents();
 };
 
 #endif
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include <fstream>
+#include <algorithm>
+#include <new>
 
 #include "CBSTree.h"
 #include "CBSNode.h"
@@ -6,16 +8,17 @@
 #include "Exceptions.h"
 #include "Coordinates.h"
 #include "Agent.h"
+#include "AStarNode.h"
+#include "LPAStarSearch.h"
+#include "PathCache.h"
+#include "PrioritizedPlanner.h"
+#include "CancelToken.h"
 #include "Macros.h"
 
 #ifdef CONFLICT_DATA
 #include <iostream>
 #endif
 
-#ifdef TIME_LIMIT
-#include <ctime>
-#endif
-
 /* 
 * Operator for comparing two CBSNodes in the Compare struct for use in priority queue (minheap)
 * @param lhs: The first CBSNode to compare
@@ -31,29 +34,166 @@ bool Compare::operator()(const CBSNode* lhs, const CBSNode* rhs) const
 * Constructor based on files describing the world and agents
 * @param agent_file: The name of the file containing each agent
 * @param world_file: The name of the file containing the world
+* @param p_options: Configuration of the search, NULL for the defaults of Macros.h
+* @param create_root: False if a subclass finds solutions without a CBS search
 */
 #include <iostream>
-CBSTree::CBSTree(std::string agent_file, std::string world_file)
+CBSTree::CBSTree(
+	std::string agent_file, std::string world_file,
+	const SolverOptions* p_options, bool create_root
+	)
 {
-#ifdef TIME_LIMIT
-	/* Get the start time of the algorithm */
-	start_time = std::clock();
-#endif
+	init_search(p_options);
+
+	/* Start the deadline of the algorithm */
+	cancel_token = new CancelToken(options.time_limit);
+	owns_token = true;
 
-	/* Initialize closed CBSNode list */
-	closed_nodes = std::vector<CBSNode*>();
+	/* Measure the memory high-water marks, repair decisions and expansions of this run only */
+	AStarNode::reset_peak_count();
+	LPAStarSearch::reset_peak_count();
+	Agent::reset_search_counts();
 
 	/* Create a world for the agents to explore */
 	world = new World(world_file);
+	owns_world = true;
 
 	/* Generate array of agents */
 	generate_agents(agent_file);
 
-	/* Create the root CBSNode */
+	if (create_root)
+		push_root();
+}
+
+/*
+* Constructor for a world that was already loaded, so several searches can share
+* it. The World belongs to the caller.
+* @param p_world: The World the agents explore
+* @param agent_file: The name of the file containing each agent
+* @param p_options: Configuration of the search, NULL for the defaults of Macros.h
+*/
+CBSTree::CBSTree(World* p_world, std::string agent_file, const SolverOptions* p_options)
+{
+	init_search(p_options);
+
+	/* Start the deadline of the algorithm */
+	cancel_token = new CancelToken(options.time_limit);
+	owns_token = true;
+
+	/* Measure the memory high-water marks, repair decisions and expansions of this run only */
+	AStarNode::reset_peak_count();
+	LPAStarSearch::reset_peak_count();
+	Agent::reset_search_counts();
+
+	world = p_world;
+	owns_world = false;
+	generate_agents(agent_file);
+
+	push_root();
+}
+
+/*
+* Constructor for agents that were already created (e.g. with constraints of
+* their own). The tree deletes the agents but the World belongs to the caller.
+* @param p_world: The World the agents explore
+* @param p_agents: The agents to find conflict free paths for
+*/
+CBSTree::CBSTree(World* p_world, std::vector<Agent*>* p_agents)
+{
+	/* Use the configuration of the agents, their searches are already set up by it */
+	init_search((*p_agents)[0]->get_options());
+
+	/* Share the deadline of whoever created the agents, or stop only when cancelled */
+	cancel_token = (*p_agents)[0]->get_cancel_token();
+	owns_token = cancel_token == NULL;
+	if (owns_token)
+		cancel_token = new CancelToken();
+
+	world = p_world;
+	owns_world = false;
+	agents = *p_agents;
+
+	push_root();
+}
+
+/*
+* Initialize the configuration, search statistics and limits
+* @param p_options: Configuration of the search, NULL for the defaults of Macros.h
+*/
+void CBSTree::init_search(const SolverOptions* p_options)
+{
+	options = p_options != NULL ? *p_options : *SolverOptions::get_defaults();
+
+	/* No agent released yet */
+	evictions = 0;
+	memory_budget = options.memory_budget;
+
+	/* No known solution */
+	upper_bound = -1;
+
+	/* No node expanded yet */
+	expansion_limit = 0;
+	cbs_expansions = 0;
+	unreachable = 0;
+
+	/* No node generated yet */
+	duplicates = 0;
+	generated_nodes = std::unordered_set<unsigned long long>();
+
+	/* Nothing has stopped the search yet */
+	status = SEARCH_RUNNING;
+	depth_pruned = false;
+
+	/* Share low level results across the whole tree */
+	path_cache = new PathCache(options.path_cache_size);
+}
+
+/*
+* Create the root CBSNode from the agents and push it onto the heap
+*/
+void CBSTree::push_root()
+{
+	/* Reject agents whose goal is not connected to their start without searching */
+	int len = agents.size();
+	for (int i = 0; i < len; i++)
+	{
+		if (!world->connected(agents[i]->get_start(), agents[i]->get_goal()))
+		{
+			status = SEARCH_INFEASIBLE;
+			return;
+		}
+	}
+
+	/* Agents that stay at their goals cannot share one */
+	for (int i = 0; options.target_reasoning && i < len; i++)
+	{
+		for (int j = i + 1; j < len; j++)
+		{
+			if (*agents[i]->get_goal() == *agents[j]->get_goal())
+			{
+				status = SEARCH_INFEASIBLE;
+				return;
+			}
+		}
+	}
+
+	/*
+	* Create the root CBSNode, agents without constraints only fail if they have no path,
+	* reach SEARCH_DEPTH or run out of time
+	*/
 	CBSNode* root = new CBSNode(&agents);
+	if (root->get_status() != SEARCH_SOLVED)
+	{
+		status = root->get_status();
+		delete root;
+		return;
+	}
+
+	/* The root is the first generated node */
+	generated_nodes.insert(root->get_hash());
 
 	/* Place the root CBSNode onto the tree */
-	tree.push(root);
+	push_node(root);
 }
 
 /* 
@@ -145,7 +285,7 @@ void CBSTree::generate_agents(std::string txt_file)
 		goal = str_to_coord(coord_str);
 
 		/* Create a new agent and add it to the vector of agents */
-		Agent* add_agent = new Agent(start, goal, world, name,start_time);
+		Agent* add_agent = new Agent(start, goal, world, name, cancel_token, &options);
 		agents.push_back(add_agent);
 
 		/* Clean up start and goal */
@@ -223,89 +363,172 @@ Coord* CBSTree::str_to_coord(std::string coord_str)
 /* 
 * Get the solution of the MAPF problem 
 * @return the solution CBSNode
+* @exceptions: Throws a TerminalException describing the status if there is no solution
 */
 CBSNode* CBSTree::get_solution()
+{
+	CBSNode* solution_node = solve();
+	if (solution_node == NULL)
+		throw TerminalException(status_message(status));
+	return solution_node;
+}
+
+/*
+* Get the solution of the MAPF problem without throwing. The reason the search
+* stopped is kept as the tree's status.
+* @return the solution CBSNode, NULL if the search stopped without one
+*/
+CBSNode* CBSTree::solve()
+{
+	/* The root could not be created */
+	if (status != SEARCH_RUNNING && status != SEARCH_SOLVED)
+		return NULL;
+	status = SEARCH_RUNNING;
+
+	try
+	{
+		CBSNode* solution_node = search_tree();
+		if (solution_node != NULL)
+			status = SEARCH_SOLVED;
+		return solution_node;
+	}
+	catch (std::bad_alloc& ex)
+	{
+		status = SEARCH_MEMORY_LIMIT;
+		return NULL;
+	}
+}
+
+/*
+* Expand CBSNodes until a solution is found or the search stops. A search
+* that stops without a solution sets the status to the reason it stopped.
+* @return the solution CBSNode, NULL if the search stopped without one
+*/
+CBSNode* CBSTree::search_tree()
 {
 	while (!tree.empty())
 	{
-#ifdef TIME_LIMIT
-		/* Stop the program early if testing for time */
-		if ((std::clock() - start_time) / CLOCKS_PER_SEC > TIME_LIMIT)
-			throw TerminalException("TIME LIMIT EXCEEDED");
-#endif
+		/* Stop the search early if it was cancelled or ran out of time */
+		if (cancel_token->check())
+		{
+			status = SEARCH_TIMEOUT;
+			return NULL;
+		}
+
+		/* Stop the search early if it is limited to a number of expansions */
+		if (expansion_limit != 0 && cbs_expansions >= expansion_limit)
+		{
+			status = SEARCH_EXPANSION_LIMIT;
+			return NULL;
+		}
 
 		/* Get the cheapest CBS Node in the heap */
-		CBSNode* top = tree.top();
-		tree.pop();
+		CBSNode* top = pop_node();
+		cbs_expansions++;
 
-		/* First conflict agent's index and conflict position */
+		/* Conflict agents' indices and the constraints resolving their conflict */
 		int agent_1;
-		Position* conflict_1 = new Position();
-
-		/* Second conflict agent's index and conflict position */
 		int agent_2;
-		Position* conflict_2 = new Position();
+		std::vector<Position> constraints_1 = std::vector<Position>();
+		std::vector<Position> constraints_2 = std::vector<Position>();
 
 		/* Get the conflicts in the node and check if a solution was found */
-		if (!top->get_conflicts(&agent_1, conflict_1, &agent_2, conflict_2))
+		if (!top->get_conflicts(
+			&agent_1, &constraints_1, &agent_2, &constraints_2, options.corridor_reasoning
+			))
 			return top;
 
 #ifdef CONFLICT_DATA
 		else
 		{
-			std::cout << "Conflict 1: " << *conflict_1->get_coord() << " at depth " <<
-				conflict_1->get_depth() << std::endl;
-			std::cout << "Conflict 2: " << *conflict_2->get_coord() << " at depth " <<
-				conflict_2->get_depth() << std::endl;
+			std::cout << "Conflict 1: " << *constraints_1[0].get_coord() << " at depth " <<
+				constraints_1[0].get_depth() << std::endl;
+			std::cout << "Conflict 2: " << *constraints_2[0].get_coord() << " at depth " <<
+				constraints_2[0].get_depth() << std::endl;
 		}
 #endif
 
 		/* No solution was found, create two new nodes to add to the heap */
-		try
-		{
-			/* Only add a node if it does not run out of nodes in the A* search */
-			CBSNode* add_node_1 = new CBSNode(top, agent_1, conflict_1);
-			tree.push(add_node_1);
-		}
-		catch (OutOfNodesException& ex)
+		if (constraints_1.size() > 1 || constraints_2.size() > 1)
 		{
-			/* No need to do anything in this catch block */
-			;
+			generate_child(top, agent_1, &constraints_1);
+			generate_child(top, agent_2, &constraints_2);
 		}
-		try
-		{
-			/* Only add a node if it does not run out of nodes in the A* search */
-			CBSNode* add_node_2 = new CBSNode(top, agent_2, conflict_2);
-			tree.push(add_node_2);
-		}
-		catch (OutOfNodesException& ex)
+		else if (options.disjoint_splitting && constraints_1[0] == constraints_2[0])
+			split_disjoint(top, agent_1, agent_2, &constraints_1[0]);
+		else
 		{
-			/* No need to do anything in this catch block */
-			;
+			generate_child(top, agent_1, &constraints_1[0]);
+			generate_child(top, agent_2, &constraints_2[0]);
 		}
 
-		/* Conflict pointers no longer necessary (copied by value when creating new CBSNodes) */
-		delete conflict_1;
-		delete conflict_2;
+		/*
+		* The explored CBS Node is no longer needed. Its agent is shared with
+		* the new nodes and is only deleted once it has no live descendants.
+		*/
+		delete top;
+
+		/* A low level search ran out of time */
+		if (status == SEARCH_TIMEOUT)
+			return NULL;
 
-		/* Store the explored CBS Node on the closed list */
-		closed_nodes.push_back(top);
+		/* Trade CPU for memory if the new agents exceeded the budget */
+		if (memory_budget != 0 && AStarNode::get_live_count() > memory_budget)
+			enforce_memory_budget();
 	}
-	/* Throw an error if you run out of CBS Nodes */
-	throw TerminalException("Ran out of CBS nodes.");
+
+	/* Every cheaper node was pruned, so the warm start plan is the solution */
+	if (!warm_plan.empty())
+		return plan_node(&warm_plan);
+
+	/* Out of CBS Nodes, some may have been cut off by SEARCH_DEPTH rather than proven infeasible */
+	status = depth_pruned ? SEARCH_DEPTH_EXCEEDED : SEARCH_INFEASIBLE;
+	return NULL;
+}
+
+/*
+* Message describing a search outcome, as thrown by get_solution()
+* @param p_status: The outcome of the search
+* @return the message
+*/
+std::string CBSTree::status_message(SearchStatus p_status)
+{
+	switch (p_status)
+	{
+	case SEARCH_RUNNING:
+		return "Search still running.";
+	case SEARCH_SOLVED:
+		return "Solution found.";
+	case SEARCH_INFEASIBLE:
+		return "Ran out of CBS nodes.";
+	case SEARCH_DEPTH_EXCEEDED:
+		return "Exceeded max search depth.";
+	case SEARCH_TIMEOUT:
+		return "TIME LIMIT EXCEEDED";
+	case SEARCH_EXPANSION_LIMIT:
+		return "EXPANSION LIMIT EXCEEDED";
+	case SEARCH_MEMORY_LIMIT:
+		return "MEMORY LIMIT EXCEEDED";
+	case SEARCH_UNSUPPORTED:
+		return "Search does not support the request.";
+	case SEARCH_PRIORITY_FAILED:
+		return "Prioritized planning failed.";
+	}
+	return "Unknown search status.";
 }
 
 /* 
 * Print the solution of the tree to an output file
+* @return the outcome of the search, nothing is printed unless it is SEARCH_SOLVED
 */
-void CBSTree::file_print_solution()
+SearchStatus CBSTree::file_print_solution()
 {
 	/* Get the solution */
-	CBSNode* solution_node = get_solution();
+	CBSNode* solution_node = solve();
 
 	/* Make sure a solution node is returned */
 	if (solution_node == NULL)
-		throw TerminalException("No path found.");
+		return status;
 
 	/* Get the solution agents */
 	std::vector<Agent*> solution_agents = *solution_node->get_agents();
@@ -323,6 +546,265 @@ void CBSTree::file_print_solution()
 
 	/* Close the output file */
 	file.close();
+	return status;
+}
+
+/*
+* Generate a child CBSNode and push it onto the heap. Different branch orders can
+* reach equal constraint sets, so a child whose constraint set hash was already
+* generated is dropped before its agent is built.
+* @param parent_node: The CBSNode being expanded
+* @param agent_num: The number of the agent who receives the conflict
+* @param conflict: The conflict to add to the agent
+* @param positive_num: The number of the agent who must be at the conflict instead,
+* -1 if there is none
+*/
+void CBSTree::generate_child(CBSNode* parent_node, int agent_num, Position* conflict, int positive_num)
+{
+	/* Skip nodes equal to an already generated node */
+	unsigned long long hash = CBSNode::child_hash(parent_node, agent_num, conflict, positive_num);
+	if (!generated_nodes.insert(hash).second)
+	{
+		duplicates++;
+		return;
+	}
+
+	/* Skip nodes whose agent can no longer reach its goal before searching */
+	if (!(*parent_node->get_agents())[agent_num]->can_reach_goal(conflict))
+	{
+		unreachable++;
+		return;
+	}
+
+	push_child(new CBSNode(parent_node, agent_num, conflict, path_cache, positive_num));
+}
+
+/*
+* Generate a child CBSNode whose agent receives several constraints at once and push
+* it onto the heap, unless a node with the same constraint sets was already generated
+* or the constraints leave the agent unable to reach its goal
+* @param parent_node: The CBSNode being expanded
+* @param agent_num: The number of the agent who receives the constraints
+* @param constraints: The constraints to add to the agent
+*/
+void CBSTree::generate_child(CBSNode* parent_node, int agent_num, std::vector<Position>* constraints)
+{
+	/* Skip nodes equal to an already generated node */
+	if (!generated_nodes.insert(CBSNode::child_hash(parent_node, agent_num, constraints)).second)
+	{
+		duplicates++;
+		return;
+	}
+
+	/* Skip nodes whose agent can no longer reach its goal before searching */
+	if (!(*parent_node->get_agents())[agent_num]->can_reach_goal(constraints))
+	{
+		unreachable++;
+		return;
+	}
+
+	push_child(new CBSNode(parent_node, agent_num, constraints, path_cache));
+}
+
+/*
+* Push a generated child CBSNode onto the heap. Only a node whose agent has a solution
+* is added, a node costing more than a known solution is dropped.
+* @param add_node: The child CBSNode, deleted if it is not added
+*/
+void CBSTree::push_child(CBSNode* add_node)
+{
+	switch (add_node->get_status())
+	{
+	case SEARCH_SOLVED:
+		break;
+	case SEARCH_TIMEOUT:
+		/* The whole search stops, not just this branch */
+		status = SEARCH_TIMEOUT;
+		delete add_node;
+		return;
+	case SEARCH_DEPTH_EXCEEDED:
+		depth_pruned = true;
+		delete add_node;
+		return;
+	default:
+		delete add_node;
+		return;
+	}
+
+	/* A known solution is at least as cheap as anything below this node */
+	if (upper_bound != -1 && add_node->get_cost() > upper_bound)
+		delete add_node;
+	else
+		push_node(add_node);
+}
+
+/*
+* Split a CBSNode on a vertex conflict into children that share no solution. In one
+* child the first agent may not be at the conflict, in the other it must be (a landmark)
+* and the second agent may not be. An agent already held at the conflict by a landmark
+* leaves only the child that moves the other agent away.
+* @param parent_node: The CBSNode being expanded
+* @param agent_1: The number of the agent split on
+* @param agent_2: The number of the other agent of the conflict
+* @param conflict: The position both agents occupy
+*/
+void CBSTree::split_disjoint(CBSNode* parent_node, int agent_1, int agent_2, Position* conflict)
+{
+	std::vector<Agent*>* node_agents = parent_node->get_agents();
+	if ((*node_agents)[agent_1]->has_landmark(conflict))
+		generate_child(parent_node, agent_2, conflict);
+	else if ((*node_agents)[agent_2]->has_landmark(conflict))
+		generate_child(parent_node, agent_1, conflict);
+	else
+	{
+		generate_child(parent_node, agent_1, conflict);
+		generate_child(parent_node, agent_2, conflict, agent_1);
+	}
+}
+
+/*
+* Find a plan by prioritized planning and use its cost as the upper bound.
+* Agents leave the world at their goal, as they do in CBS solutions, unless
+* target reasoning keeps them there.
+* @return true if prioritized planning found a plan
+*/
+bool CBSTree::warm_start()
+{
+	PrioritizedPlanner planner = PrioritizedPlanner(&agents);
+	planner.set_park_at_goal(options.target_reasoning);
+	if (!planner.plan())
+		return false;
+	warm_plan = *planner.get_paths();
+	upper_bound = planner.get_cost();
+	return true;
+}
+
+/*
+* Create a CBSNode holding a plan. The node's agents belong to the tree.
+* @param plan: One path per agent
+* @return the CBSNode, which the caller deletes
+*/
+CBSNode* CBSTree::plan_node(std::vector<std::stack<Coord> >* plan)
+{
+	int num_agents = agents.size();
+	for (int i = 0; i < num_agents; i++)
+		plan_agents.push_back(new Agent(agents[i], NULL, &(*plan)[i]));
+	return new CBSNode(&plan_agents);
+}
+
+/*
+* Push a CBSNode onto the heap
+* @param node: The CBSNode to push
+*/
+void CBSTree::push_node(CBSNode* node)
+{
+	tree.push_back(node);
+	std::push_heap(tree.begin(), tree.end(), Compare());
+}
+
+/*
+* Pop the cheapest CBSNode off of the heap
+* @return the cheapest CBSNode
+*/
+CBSNode* CBSTree::pop_node()
+{
+	std::pop_heap(tree.begin(), tree.end(), Compare());
+	CBSNode* top = tree.back();
+	tree.pop_back();
+	return top;
+}
+
+/*
+* Release the OPEN and CLOSED lists of agents on the open CBSNodes until the
+* number of A* Nodes falls below the memory budget. The most expensive nodes are
+* the last to be expanded, so their agents are evicted first. Evicted agents keep
+* their path, cost and constraints, and their children search from scratch.
+*/
+void CBSTree::enforce_memory_budget()
+{
+	/* Evict down to a fraction of the budget so the next few expansions fit */
+	const double LOW_WATER = 0.75;
+	unsigned long target = static_cast<unsigned long>(memory_budget * LOW_WATER);
+
+	/* Visit the open nodes from most to least expensive */
+	std::vector<CBSNode*> by_cost = tree;
+	std::sort(by_cost.begin(), by_cost.end(), Compare());
+
+	int num_nodes = by_cost.size();
+	for (int i = 0; i < num_nodes; i++)
+	{
+		std::vector<Agent*>* node_agents = by_cost[i]->get_agents();
+		int num_agents = node_agents->size();
+		for (int j = 0; j < num_agents; j++)
+		{
+			if ((*node_agents)[j]->is_evicted())
+				continue;
+
+			(*node_agents)[j]->evict();
+			evictions++;
+
+			if (AStarNode::get_live_count() <= target)
+				return;
+		}
+	}
+}
+
+/*
+* Number of child agents repaired with PCA* since the tree was created
+* @return the repair count of this run
+*/
+unsigned long CBSTree::get_repairs()
+{
+	return Agent::get_repair_count();
+}
+
+/*
+* Number of child agents searched again from the start since the tree was created
+* @return the restart count of this run
+*/
+unsigned long CBSTree::get_restarts()
+{
+	return Agent::get_restart_count();
+}
+
+/*
+* Number of states the A* and LPA* searches expanded since the tree was created
+* @return the expansion count of this run
+*/
+unsigned long CBSTree::get_expansions()
+{
+	return Agent::get_expansion_count();
+}
+
+/*
+* Most LPA* states kept at once since the tree was created
+* @return the LPA* state high-water mark of this run
+*/
+unsigned long CBSTree::get_peak_states()
+{
+	return LPAStarSearch::get_peak_count();
+}
+
+/*
+* Most A* Nodes allocated at once since the tree was created
+* @return the A* Node high-water mark of this run
+*/
+unsigned long CBSTree::get_peak_nodes()
+{
+	return AStarNode::get_peak_count();
+}
+
+/*
+* Estimate the memory used by the search at its high-water mark. Each A* Node
+* is also referenced by a hash table entry and (on the OPEN list) a heap slot.
+* @return the estimated number of bytes at the A* Node high-water mark
+*/
+unsigned long CBSTree::get_peak_bytes()
+{
+	/* Hash table entry (next pointer, key, value) and heap slot per node */
+	const unsigned long NODE_OVERHEAD = 4 * sizeof(void*);
+
+	return get_peak_nodes() * (sizeof(AStarNode) + NODE_OVERHEAD);
 }
 
 /*
@@ -334,24 +816,18 @@ CBSTree::~CBSTree()
 	int num_agents = agents.size();
 	for (int i = 0; i < num_agents; i++)
 		delete agents[i];
+	int num_plan_agents = plan_agents.size();
+	for (int i = 0; i < num_plan_agents; i++)
+		delete plan_agents[i];
 
 	/* Delete all open CBSNodes */
-	CBSNode* del_node;
 	while (!tree.empty())
-	{
-		del_node = tree.top();
-		tree.pop();
-		delete del_node;
-	}
-
-	/* Delete all closed CBS Nodes */
-	while (!closed_nodes.empty())
-	{
-		del_node = closed_nodes.back();
-		closed_nodes.pop_back();
-		delete del_node;
-	}
-
-	/* Delete the world */
-	delete world;
+		delete pop_node();
+
+	/* Delete the world and the shared results */
+	if (owns_world)
+		delete world;
+	delete path_cache;
+	if (owns_token)
+		delete cancel_token;
 }
\ No newline at end of file
@@ -4,14 +4,20 @@
 #include <queue>
 #include <string>
 #include <functional>
-#include <ctime>
+#include <unordered_set>
+#include <vector>
+#include <stack>
 
 #include "Macros.h"
+#include "Coordinates.h"
+#include "SearchStatus.h"
+#include "SolverOptions.h"
 
 class CBSNode;
 class Agent;
 class World;
-class Coord;
+class PathCache;
+class CancelToken;
 
 /* Struct for comparing two CBSNodes by cost */
 struct Compare : public std::binary_function<CBSNode*, CBSNode*, bool>
@@ -22,33 +28,129 @@ struct Compare : public std::binary_function<CBSNode*, CBSNode*, bool>
 class CBSTree
 {
 public:
-	/* Constructor */
-	CBSTree(std::string agent_file, std::string world_file);
-	/* Get the solution of the MAPF problem */
+	/* Constructors */
+	CBSTree(
+		std::string agent_file, std::string world_file,
+		const SolverOptions* p_options = NULL, bool create_root = true
+		);
+	CBSTree(World* p_world, std::string agent_file, const SolverOptions* p_options = NULL);
+	CBSTree(World* p_world, std::vector<Agent*>* p_agents);
+	/* Get the solution of the MAPF problem, NULL if the search stopped without one */
+	CBSNode* solve();
+	/* Get the solution of the MAPF problem, throwing if there is none */
 	CBSNode* get_solution();
 	/* Print the solution of the tree to an output file */
-	void file_print_solution();
+	SearchStatus file_print_solution();
+	/* Outcome of the search */
+	SearchStatus get_status() const { return status; };
+	/* Message describing a search outcome */
+	static std::string status_message(SearchStatus p_status);
+
+	/* Most A* Nodes allocated at once during the search and the estimated memory they used */
+	unsigned long get_peak_nodes();
+	unsigned long get_peak_bytes();
+	/* Number of child agents repaired with PCA* and searched again from the start */
+	unsigned long get_repairs();
+	unsigned long get_restarts();
+	/* Number of states expanded by the low level searches */
+	unsigned long get_expansions();
+	/* Most LPA* states kept at once during the search */
+	unsigned long get_peak_states();
+	/* Limit the number of A* Nodes kept in memory (0 for no limit) */
+	void set_memory_budget(unsigned long p_memory_budget) { memory_budget = p_memory_budget; };
+	/* Number of agents whose OPEN and CLOSED lists were released */
+	int get_evictions() const { return evictions; };
+	/* Prune CBSNodes costing more than a known solution (-1 for no bound) */
+	void set_upper_bound(int p_upper_bound) { upper_bound = p_upper_bound; };
+	/* Find a plan by prioritized planning and use it as the upper bound */
+	bool warm_start();
+	int get_upper_bound() const { return upper_bound; };
+	/* Stop the search after a number of CBSNode expansions (0 for no limit) */
+	void set_expansion_limit(int p_expansion_limit) { expansion_limit = p_expansion_limit; };
+	/* Number of CBSNodes expanded */
+	int get_cbs_expansions() const { return cbs_expansions; };
+	/* Number of CBSNodes dropped because an equal node was already generated */
+	int get_duplicates() const { return duplicates; };
+	/* Number of CBSNodes dropped because their constraints cut an agent off from its goal */
+	int get_unreachable() const { return unreachable; };
+	/* Low level results shared by every CBSNode of the tree */
+	PathCache* get_path_cache() { return path_cache; };
+	/* Deadline of the search, cancel() it from another thread to stop the search */
+	CancelToken* get_cancel_token() { return cancel_token; };
+	/* Configuration of the tree and its agents */
+	const SolverOptions* get_options() { return &options; };
 	
 	/* Destructor */
-	~CBSTree();
-private:
-	/* Minheap of CBSNodes, sorted by cost */
-	std::priority_queue<CBSNode*, std::vector<CBSNode*>, Compare> tree;
+	virtual ~CBSTree();
+protected:
+	/* Minheap of CBSNodes, sorted by cost (kept as a vector so every open node can be visited) */
+	std::vector<CBSNode*> tree;
 	/* Vector of agents generated from a text file */
 	std::vector<Agent*> agents;
 	/* World the agents must explore */
 	World* world;
-	/* CBSNodes that were previously explored */
-	std::vector<CBSNode*> closed_nodes;
+	/* False if the World belongs to the caller */
+	bool owns_world;
 
 	/* Generate an array of agents from a text file */
 	void generate_agents(std::string txt_file);
 	/* Convert a coordinate in the format ({int},{int}) to a Coord object */
 	Coord* str_to_coord(std::string coord_str);
+	/* Initialize the configuration, search statistics and limits */
+	void init_search(const SolverOptions* p_options);
+	/* Create the root CBSNode from the agents and push it onto the heap */
+	void push_root();
+	/* Push a CBSNode onto the heap and pop the cheapest CBSNode off of it */
+	void push_node(CBSNode* node);
+	CBSNode* pop_node();
+	/* Release the search state of frontier agents until the memory budget is met */
+	void enforce_memory_budget();
+
+	/* Maximum number of A* Nodes kept in memory, 0 if there is no limit */
+	unsigned long memory_budget;
+	/* Number of agents whose OPEN and CLOSED lists were released */
+	int evictions;
+	/* Cost of a known solution, -1 if there is none */
+	int upper_bound;
+	/* Plan found by warm_start, returned if no cheaper solution is found */
+	std::vector<std::stack<Coord> > warm_plan;
+	/* Agents holding plans returned as CBSNodes */
+	std::vector<Agent*> plan_agents;
+	/* Create a CBSNode holding a plan of one path per agent */
+	CBSNode* plan_node(std::vector<std::stack<Coord> >* plan);
+	/* Maximum number of CBSNodes expanded, 0 if there is no limit */
+	int expansion_limit;
+	/* Number of CBSNodes expanded, get_expansions() counts the low level states instead */
+	int cbs_expansions;
+	/* Hashes of the constraint sets of every CBSNode generated so far */
+	std::unordered_set<unsigned long long> generated_nodes;
+	/* Number of CBSNodes dropped because an equal node was already generated */
+	int duplicates;
+	/* Number of CBSNodes dropped because their constraints cut an agent off from its goal */
+	int unreachable;
+	/* Low level results keyed by agent and constraint set */
+	PathCache* path_cache;
+	/* Outcome of the search, SEARCH_RUNNING until it stops */
+	SearchStatus status;
+	/* True once a child CBSNode is dropped because its agent reached SEARCH_DEPTH */
+	bool depth_pruned;
+
+	/* Expand CBSNodes until a solution is found or the search stops, setting the status */
+	virtual CBSNode* search_tree();
+	/* Generate a child CBSNode and push it onto the heap unless it duplicates a prior node */
+	void generate_child(CBSNode* parent_node, int agent_num, Position* conflict, int positive_num = -1);
+	void generate_child(CBSNode* parent_node, int agent_num, std::vector<Position>* constraints);
+	/* Push a generated child CBSNode onto the heap if its agent has a solution */
+	void push_child(CBSNode* add_node);
+	/* Split a CBSNode on a conflict into children that share no solution */
+	void split_disjoint(CBSNode* parent_node, int agent_1, int agent_2, Position* conflict);
 
-#ifdef TIME_LIMIT
-	std::time_t start_time;
-#endif
+	/* Deadline and cancellation flag shared with every agent of the tree */
+	CancelToken* cancel_token;
+	/* False if the token belongs to whoever created the agents */
+	bool owns_token;
+	/* Configuration of the tree, the agents of the tree point to it */
+	SolverOptions options;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "CancelToken.h"
+#include "Macros.h"
+
+/*
+* Constructor
+* @param time_limit: Seconds the searches may run for, 0 if there is no deadline
+*/
+CancelToken::CancelToken(double time_limit)
+{
+	cancelled.store(false, std::memory_order_relaxed);
+	expired = false;
+	start = std::chrono::steady_clock::now();
+	set_time_limit(time_limit);
+}
+
+/*
+* Move the deadline to a number of seconds from now
+* @param time_limit: Seconds the searches may run for, 0 if there is no deadline
+*/
+void CancelToken::set_time_limit(double time_limit)
+{
+	has_deadline = time_limit > 0;
+	deadline = std::chrono::steady_clock::now() +
+		std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double>(time_limit));
+	countdown = CANCEL_CHECK_INTERVAL;
+}
+
+/*
+* Check if the searches must stop, reading the clock only every CANCEL_CHECK_INTERVAL calls
+* @return true if the token was cancelled or its deadline has passed
+*/
+bool CancelToken::poll()
+{
+	if (expired)
+		return true;
+	if (cancelled.load(std::memory_order_relaxed))
+	{
+		expired = true;
+		return true;
+	}
+	if (--countdown != 0)
+		return false;
+	return check();
+}
+
+/*
+* Check if the searches must stop, reading the clock now
+* @return true if the token was cancelled or its deadline has passed
+*/
+bool CancelToken::check()
+{
+	countdown = CANCEL_CHECK_INTERVAL;
+	if (cancelled.load(std::memory_order_relaxed) ||
+		(has_deadline && std::chrono::steady_clock::now() >= deadline))
+		expired = true;
+	return expired;
+}
+
+/*
+* Get the wall clock time since the token was created
+* @return the elapsed time in seconds
+*/
+double CancelToken::get_elapsed() const
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
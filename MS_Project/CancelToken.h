@@ -0,0 +1,49 @@
+#ifndef CANCELTOKEN_H
+#define CANCELTOKEN_H
+
+#include <atomic>
+#include <chrono>
+
+/*
+* Cooperative deadline and cancellation shared by every search of a CBSTree.
+* Searches poll the token once per expansion; the wall clock deadline is only
+* read every CANCEL_CHECK_INTERVAL polls, while the cancellation flag (which a
+* host process may set from another thread) is read on every poll. Once the
+* token stops a search it stays stopped.
+*/
+class CancelToken
+{
+public:
+	/* Constructor, a time limit of 0 seconds means there is no deadline */
+	CancelToken(double time_limit = 0);
+
+	/* Cheap check for the hot loops, reads the clock every CANCEL_CHECK_INTERVAL calls */
+	bool poll();
+	/* Check the flag and the deadline now */
+	bool check();
+	/* Stop every search polling this token, safe to call from any thread */
+	void cancel() { cancelled.store(true, std::memory_order_relaxed); };
+	/* Move the deadline to a number of seconds from now, 0 for no deadline */
+	void set_time_limit(double time_limit);
+
+	/* Accessors */
+	bool is_cancelled() const { return cancelled.load(std::memory_order_relaxed); };
+	bool is_expired() const { return expired; };
+	/* Seconds since the token was created */
+	double get_elapsed() const;
+private:
+	/* Set by cancel() */
+	std::atomic<bool> cancelled;
+	/* True once the deadline has passed or the token was cancelled */
+	bool expired;
+	/* Time the token was created */
+	std::chrono::steady_clock::time_point start;
+	/* Time the searches must stop by */
+	std::chrono::steady_clock::time_point deadline;
+	/* False if only cancel() stops the searches */
+	bool has_deadline;
+	/* Polls left before the clock is read again */
+	unsigned int countdown;
+};
+
+#endif
@@ -0,0 +1,48 @@
+#include "ConflictKernel.h"
+#include "Coordinates.h"
+#include "World.h"
+
+/*
+* Constructor
+* @param world: The World the agents move in
+* @param last_depth: The deepest depth a cell can be occupied at
+*/
+ConflictKernel::ConflictKernel(World* world, int last_depth)
+{
+	width = world->get_max_x() + 1;
+	words = (world->get_size() + WORD_BITS - 1) / WORD_BITS;
+	bits = std::vector<unsigned long long>((last_depth + 1) * words, 0);
+}
+
+/*
+* Check if a cell is occupied at a depth
+* @param coord: The coordinate of the cell
+* @param depth: The depth, no deeper than the last depth
+* @return true if the cell was occupied at the depth
+*/
+bool ConflictKernel::is_occupied(Coord* coord, int depth)
+{
+	int cell = get_cell(coord);
+	return (bits[depth * words + cell / WORD_BITS] >> (cell % WORD_BITS)) & 1;
+}
+
+/*
+* Mark a cell occupied at a depth
+* @param coord: The coordinate of the cell
+* @param depth: The depth, no deeper than the last depth
+*/
+void ConflictKernel::occupy(Coord* coord, int depth)
+{
+	int cell = get_cell(coord);
+	bits[depth * words + cell / WORD_BITS] |= 1ULL << (cell % WORD_BITS);
+}
+
+/*
+* Index of the bit of a cell in the bitset of its depth
+* @param coord: The coordinate of the cell
+* @return the index of the cell in the World
+*/
+int ConflictKernel::get_cell(Coord* coord)
+{
+	return coord->get_ycoord() * width + coord->get_xcoord();
+}
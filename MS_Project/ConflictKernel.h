@@ -0,0 +1,41 @@
+#ifndef CONFLICTKERNEL_H
+#define CONFLICTKERNEL_H
+
+#include <vector>
+
+class Coord;
+class World;
+
+/*
+* Occupancy of the cells of a World at each depth of a CBSNode's solution, one
+* bit per cell. CBSNode::get_conflicts rasterizes the paths agent by agent and
+* tests each position against the agents before it, so a position costs a bit
+* test instead of a hash table entry. Only a move into a cell occupied at the
+* previous depth can be a swap, so edges are only checked there.
+*/
+class ConflictKernel
+{
+public:
+	/* Constructor, no cell is occupied at any depth up to the last depth */
+	ConflictKernel(World* world, int last_depth);
+
+	/* Check if a cell is occupied at a depth */
+	bool is_occupied(Coord* coord, int depth);
+	/* Mark a cell occupied at a depth */
+	void occupy(Coord* coord, int depth);
+private:
+	/* Bits of a word of the bitsets */
+	static const int WORD_BITS = 64;
+
+	/* Number of cells in a row of the World */
+	int width;
+	/* Number of words in the bitset of one depth */
+	int words;
+	/* Bitsets of every depth, one after the other */
+	std::vector<unsigned long long> bits;
+
+	/* Index of the bit of a cell in the bitset of its depth */
+	int get_cell(Coord* coord);
+};
+
+#endif
@@ -0,0 +1,303 @@
+#include "ConflictMatrix.h"
+#include "ConflictKernel.h"
+#include "Coordinates.h"
+#include "World.h"
+
+/*
+* Constructor
+* @param p_num_agents: The number of agents of the CBSNode
+*/
+ConflictMatrix::ConflictMatrix(int p_num_agents)
+{
+	num_agents = p_num_agents;
+	PairConflict none = PairConflict();
+	none.depth = 0;
+	none.count = 0;
+	none.type = CONFLICT_NONE;
+	pairs = std::vector<PairConflict>(num_agents * (num_agents - 1) / 2, none);
+	stale = std::vector<bool>(num_agents, true);
+	num_stale = num_agents;
+	total = 0;
+}
+
+/*
+* Mark an agent whose path changed
+* @param agent_num: The number of the agent
+*/
+void ConflictMatrix::mark_stale(int agent_num)
+{
+	if (!stale[agent_num])
+	{
+		stale[agent_num] = true;
+		num_stale++;
+	}
+}
+
+/*
+* Check the rows of the stale agents. When every agent is stale each agent is
+* checked against the agents before it, otherwise each stale agent is checked
+* against all the other agents.
+* @param world: The World the agents move in
+* @param paths: The paths of the agents, indexed by depth
+* @param parked: True if agents stay at their goals after their paths end
+*/
+void ConflictMatrix::update(World* world, std::vector<std::vector<Coord> >* paths, bool parked)
+{
+	if (num_stale == 0)
+		return;
+
+	/* Deepest position of any path */
+	int last_depth = 0;
+	for (int i = 0; i < num_agents; i++)
+	{
+		if (static_cast<int>((*paths)[i].size()) - 1 > last_depth)
+			last_depth = (*paths)[i].size() - 1;
+	}
+
+	if (num_stale == num_agents)
+	{
+		/* Rasterize the agents one by one, checking each against the ones before it */
+		ConflictKernel occupied = ConflictKernel(world, last_depth);
+		for (int i = 0; i < num_agents; i++)
+		{
+			check_row(i, i, &occupied, paths, parked, last_depth);
+			occupy_path(i, &occupied, paths, parked, last_depth);
+		}
+	}
+	else
+	{
+		for (int i = 0; i < num_agents; i++)
+		{
+			if (!stale[i])
+				continue;
+
+			/* Check the stale agent against every other agent */
+			ConflictKernel others = ConflictKernel(world, last_depth);
+			for (int j = 0; j < num_agents; j++)
+			{
+				if (j != i)
+					occupy_path(j, &others, paths, parked, last_depth);
+			}
+			check_row(i, num_agents, &others, paths, parked, last_depth);
+		}
+	}
+
+	stale.assign(num_agents, false);
+	num_stale = 0;
+}
+
+/*
+* Get the pair whose conflict CBSNode::get_conflicts resolves: the first agent in
+* order that conflicts with an agent before it, and of the agents before it the
+* one it conflicts with first
+* @param agent_1: Will be set to the later agent of the pair
+* @param agent_2: Will be set to the earlier agent of the pair
+* @return true if a pair conflicts, false otherwise
+*/
+bool ConflictMatrix::get_first_conflict(int* agent_1, int* agent_2)
+{
+	for (int i = 1; i < num_agents; i++)
+	{
+		int first = -1;
+		for (int j = 0; j < i; j++)
+		{
+			PairConflict* pair = &pairs[get_index(i, j)];
+			if (pair->depth == 0)
+				continue;
+
+			/* A vertex conflict is found before a swap at the same depth */
+			PairConflict* first_pair = first == -1 ? NULL : &pairs[get_index(i, first)];
+			if (
+				first_pair == NULL || pair->depth < first_pair->depth ||
+				(pair->depth == first_pair->depth && pair->type == CONFLICT_VERTEX)
+				)
+				first = j;
+		}
+		if (first != -1)
+		{
+			*agent_1 = i;
+			*agent_2 = first;
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+* Get the depth of the first conflict of a pair of agents
+* @param agent_1: One agent of the pair
+* @param agent_2: The other agent of the pair
+* @return the depth, 0 if the agents never conflict
+*/
+int ConflictMatrix::get_depth(int agent_1, int agent_2)
+{
+	return pairs[get_index(agent_1, agent_2)].depth;
+}
+
+/*
+* Get the kind of the first conflict of a pair of agents
+* @param agent_1: One agent of the pair
+* @param agent_2: The other agent of the pair
+* @return the kind, CONFLICT_NONE if the agents never conflict
+*/
+ConflictType ConflictMatrix::get_type(int agent_1, int agent_2)
+{
+	return static_cast<ConflictType>(pairs[get_index(agent_1, agent_2)].type);
+}
+
+/*
+* Get the number of conflicts between the paths of a pair of agents
+* @param agent_1: One agent of the pair
+* @param agent_2: The other agent of the pair
+* @return the number of vertex and swap conflicts
+*/
+int ConflictMatrix::get_count(int agent_1, int agent_2)
+{
+	return pairs[get_index(agent_1, agent_2)].count;
+}
+
+/*
+* Get the coordinate of a path at a depth
+* @param path: The path, indexed by depth
+* @param depth: The depth
+* @param parked: True if the agent stays at its goal after its path ends
+* @return the coordinate, NULL if the path ended before the depth and the agent left the world
+*/
+Coord* ConflictMatrix::path_coord(std::vector<Coord>* path, int depth, bool parked)
+{
+	int len = path->size();
+	if (depth < len)
+		return &(*path)[depth];
+	return parked ? &(*path)[len - 1] : NULL;
+}
+
+/*
+* Index of a pair in the lower triangle of the matrix
+* @param agent_1: One agent of the pair
+* @param agent_2: The other agent of the pair
+* @return the index of the pair
+*/
+int ConflictMatrix::get_index(int agent_1, int agent_2)
+{
+	if (agent_1 < agent_2)
+		return agent_2 * (agent_2 - 1) / 2 + agent_1;
+	return agent_1 * (agent_1 - 1) / 2 + agent_2;
+}
+
+/*
+* Forget the conflicts of a pair of agents
+* @param agent_1: One agent of the pair
+* @param agent_2: The other agent of the pair
+*/
+void ConflictMatrix::clear_pair(int agent_1, int agent_2)
+{
+	PairConflict* pair = &pairs[get_index(agent_1, agent_2)];
+	total -= pair->count;
+	pair->depth = 0;
+	pair->count = 0;
+	pair->type = CONFLICT_NONE;
+}
+
+/*
+* Record a conflict of a pair of agents
+* @param agent_1: One agent of the pair
+* @param agent_2: The other agent of the pair
+* @param depth: The depth of the conflict
+* @param type: The kind of the conflict
+*/
+void ConflictMatrix::add_conflict(int agent_1, int agent_2, int depth, ConflictType type)
+{
+	PairConflict* pair = &pairs[get_index(agent_1, agent_2)];
+	pair->count++;
+	total++;
+
+	/* Keep the first conflict, a vertex conflict before a swap at the same depth */
+	if (
+		pair->depth == 0 || depth < pair->depth ||
+		(depth == pair->depth && type == CONFLICT_VERTEX)
+		)
+	{
+		pair->depth = depth;
+		pair->type = type;
+	}
+}
+
+/*
+* Check the path of an agent against the paths rasterized in a kernel, the agents
+* before num_others except the agent itself. Cells are tested a bit at a time and
+* the paths are only searched for the other agent where a bit is set.
+* @param agent_num: The number of the agent to check
+* @param num_others: The agents before this number are rasterized in occupied
+* @param occupied: The cells occupied by the other agents
+* @param paths: The paths of the agents, indexed by depth
+* @param parked: True if agents stay at their goals after their paths end
+* @param last_depth: The deepest position of any path
+*/
+void ConflictMatrix::check_row(
+	int agent_num, int num_others, ConflictKernel* occupied,
+	std::vector<std::vector<Coord> >* paths, bool parked, int last_depth
+	)
+{
+	for (int i = 0; i < num_others; i++)
+	{
+		if (i != agent_num)
+			clear_pair(agent_num, i);
+	}
+
+	std::vector<Coord>* path = &(*paths)[agent_num];
+	int end_depth = parked ? last_depth : path->size() - 1;
+	for (int depth = 1; depth <= end_depth; depth++)
+	{
+		Coord* curr_coord = path_coord(path, depth, true);
+		Coord* prev_coord = path_coord(path, depth - 1, true);
+
+		/* Other agents in the same cell at the same depth */
+		if (occupied->is_occupied(curr_coord, depth))
+		{
+			for (int i = 0; i < num_others; i++)
+			{
+				Coord* other_coord = path_coord(&(*paths)[i], depth, parked);
+				if (i != agent_num && other_coord != NULL && *other_coord == *curr_coord)
+					add_conflict(agent_num, i, depth, CONFLICT_VERTEX);
+			}
+		}
+
+		/* Only a move into a cell occupied at the previous depth can be a swap */
+		if (
+			!(*curr_coord == *prev_coord) && occupied->is_occupied(curr_coord, depth - 1) &&
+			occupied->is_occupied(prev_coord, depth)
+			)
+		{
+			for (int i = 0; i < num_others; i++)
+			{
+				Coord* other_prev = path_coord(&(*paths)[i], depth - 1, parked);
+				Coord* other_curr = path_coord(&(*paths)[i], depth, parked);
+				if (
+					i != agent_num && other_prev != NULL && other_curr != NULL &&
+					*other_prev == *curr_coord && *other_curr == *prev_coord
+					)
+					add_conflict(agent_num, i, depth, CONFLICT_SWAP);
+			}
+		}
+	}
+}
+
+/*
+* Rasterize the path of an agent. The start coordinate is only occupied for the
+* swap test of the first move, the vertex test starts at depth 1.
+* @param agent_num: The number of the agent
+* @param occupied: The kernel to mark the cells of the path in
+* @param paths: The paths of the agents, indexed by depth
+* @param parked: True if agents stay at their goals after their paths end
+* @param last_depth: The deepest position of any path
+*/
+void ConflictMatrix::occupy_path(
+	int agent_num, ConflictKernel* occupied,
+	std::vector<std::vector<Coord> >* paths, bool parked, int last_depth
+	)
+{
+	std::vector<Coord>* path = &(*paths)[agent_num];
+	int end_depth = parked ? last_depth : path->size() - 1;
+	for (int depth = 0; depth <= end_depth; depth++)
+		occupied->occupy(path_coord(path, depth, true), depth);
+}
@@ -0,0 +1,92 @@
+#ifndef CONFLICTMATRIX_H
+#define CONFLICTMATRIX_H
+
+#include <vector>
+
+class Coord;
+class World;
+class ConflictKernel;
+
+/* Kind of the first conflict between two agents */
+enum ConflictType
+{
+	/* The paths of the agents never conflict */
+	CONFLICT_NONE,
+	/* The agents occupy the same cell at the same depth */
+	CONFLICT_VERTEX,
+	/* The agents swap cells between two depths */
+	CONFLICT_SWAP
+};
+
+/*
+* Known conflicts between every pair of agents of a CBSNode: the depth and type of
+* their first conflict and the number of conflicts between their paths. A child
+* CBSNode copies the matrix of its parent and marks the agents it replaced as stale,
+* only their rows are checked again since the other paths did not change. The
+* start coordinates are assumed unique, they are only checked for agents swapping
+* cells on their first move.
+*/
+class ConflictMatrix
+{
+public:
+	/* Constructor, every agent is stale until the first update */
+	ConflictMatrix(int p_num_agents);
+
+	/* Mark an agent whose path changed, its row is checked again by the next update */
+	void mark_stale(int agent_num);
+	/* Check the rows of the stale agents against the paths of the agents */
+	void update(World* world, std::vector<std::vector<Coord> >* paths, bool parked);
+	/* Get the pair whose conflict CBSNode::get_conflicts resolves, the later agent first */
+	bool get_first_conflict(int* agent_1, int* agent_2);
+
+	/* Conflicts of a pair of agents, given in either order */
+	int get_depth(int agent_1, int agent_2);
+	ConflictType get_type(int agent_1, int agent_2);
+	int get_count(int agent_1, int agent_2);
+	/* Number of conflicts between every pair of agents */
+	int get_total() const { return total; };
+
+	/* Coordinate of a path at a depth, NULL once the agent has left the world */
+	static Coord* path_coord(std::vector<Coord>* path, int depth, bool parked);
+private:
+	/* First conflict and number of conflicts of a pair of agents */
+	struct PairConflict
+	{
+		/* Depth of the first conflict, 0 if there is none */
+		unsigned short depth;
+		/* Number of conflicts between the paths */
+		unsigned short count;
+		/* Kind of the first conflict */
+		unsigned char type;
+	};
+
+	/* Number of agents of the CBSNode */
+	int num_agents;
+	/* Conflicts of each pair of agents, the lower triangle of the matrix row by row */
+	std::vector<PairConflict> pairs;
+	/* True for the agents whose rows must be checked again */
+	std::vector<bool> stale;
+	/* Number of stale agents */
+	int num_stale;
+	/* Sum of the conflict counts of every pair */
+	int total;
+
+	/* Index of a pair in the lower triangle */
+	int get_index(int agent_1, int agent_2);
+	/* Forget the conflicts of a pair */
+	void clear_pair(int agent_1, int agent_2);
+	/* Record a conflict of a pair, keeping the first one */
+	void add_conflict(int agent_1, int agent_2, int depth, ConflictType type);
+	/* Check the path of an agent against the paths rasterized in occupied */
+	void check_row(
+		int agent_num, int num_others, ConflictKernel* occupied,
+		std::vector<std::vector<Coord> >* paths, bool parked, int last_depth
+		);
+	/* Rasterize the path of an agent */
+	void occupy_path(
+		int agent_num, ConflictKernel* occupied,
+		std::vector<std::vector<Coord> >* paths, bool parked, int last_depth
+		);
+};
+
+#endif
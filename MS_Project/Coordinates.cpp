@@ -1,4 +1,5 @@
 #include <string>
+#include <cstdlib>
 
 #include "Coordinates.h"
 #include "Exceptions.h"
@@ -38,13 +39,13 @@ Coord::Coord()
 /*
 * Equals operator
 * @param rhs: The Coord object to copy into this object
-* @return the object on the right hand side of the equal sign
+* @return this Coord object
 */
-Coord & Coord::operator=(Coord& rhs)
+Coord & Coord::operator=(const Coord& rhs)
 {
 	xcoord = rhs.get_xcoord();
 	ycoord = rhs.get_ycoord();
-	return rhs;
+	return *this;
 }
 
 /*
@@ -83,6 +84,20 @@ bool Coord::operator!=(Coord& rhs)
 	return false;
 }
 
+/*
+* Get the fewest moves to another coordinate when diagonal moves cost the same as
+* straight moves, ignoring obstacles. It never overestimates, so it is an admissible
+* and consistent heuristic for the searches.
+* @param coord: The other coordinate
+* @return the larger of the distances along the X and Y axes
+*/
+int Coord::moves_to(Coord* coord)
+{
+	int x_diff = abs(xcoord - coord->get_xcoord());
+	int y_diff = abs(ycoord - coord->get_ycoord());
+	return x_diff > y_diff ? x_diff : y_diff;
+}
+
 /* 
 * Constructor with a coordinate and depth 
 * @param p_coord: 2D coordinate (X and Y)
@@ -162,13 +177,4 @@ std::ostream& operator<<(std::ostream& out, Position& pos)
 	out << "(" << pos.get_coord()->get_xcoord() << "," << pos.get_coord()->get_ycoord() << 
 		") at depth " << pos.get_depth();
 	return out;
-}
-
-/*
-* Constructor 
-*/
-AgentPos::AgentPos(int p_agent_num, Position* p_pos)
-{
-	agent_num = p_agent_num;
-	pos = *p_pos;
 }
\ No newline at end of file
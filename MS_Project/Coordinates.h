@@ -15,7 +15,7 @@ public:
 	Coord();
 
 	/* Operator overloads */
-	Coord & operator=(Coord& rhs);
+	Coord & operator=(const Coord& rhs);
 	bool operator!=(Coord& rhs);
 	friend std::ostream & operator<<(std::ostream& out, Coord& coord);
 	bool operator==(Coord& rhs);
@@ -28,6 +28,9 @@ public:
 	unsigned short get_xcoord() const { return xcoord; };
 	unsigned short get_ycoord() const { return ycoord; };
 
+	/* Fewest moves to another coordinate on an 8-connected grid, ignoring obstacles */
+	int moves_to(Coord* coord);
+
 	/* Get a value for comparing this object to another (in MultiMap.cpp) */
 	Coord* get_comp() { return this; };
 private:
@@ -72,21 +75,4 @@ private:
 	unsigned short depth;
 };
 
-/* Class containing a Position and the agent in that Position */
-class AgentPos
-{
-public:
-	/* Constructor */
-	AgentPos(int p_agent_num, Position* p_pos);
-	
-	/* Accessors */
-	int get_agent_num() { return agent_num; };
-	Position* get_pos() { return &pos; };
-private:
-	/* The agent's index number */
-	int agent_num;
-	/* The position the agent is located in */
-	Position pos;
-};
-
 #endif
\ No newline at end of file
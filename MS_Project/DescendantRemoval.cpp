@@ -0,0 +1,202 @@
+#include <thread>
+
+#include "DescendantRemoval.h"
+#include "Agent.h"
+#include "AStarNode.h"
+#include "AStarNodeList.h"
+#include "Coordinates.h"
+#include "Exceptions.h"
+#include "HashStruct.h"
+#include "CancelToken.h"
+#include "SolverOptions.h"
+
+/*
+* Get the OPEN and CLOSED lists to remove the descendants of start_pos from
+* @param search: The Agent whose lists are cleared
+* @param p_start_pos: The newly constrained position
+*/
+DescendantRemoval::DescendantRemoval(Agent* search, Position* p_start_pos)
+{
+	/* Lists of the A* Search */
+	open_list_hash_table = search->get_open_list_hash_table();
+	closed_list = search->get_closed_list();
+
+	start_pos = p_start_pos;
+
+	layer = std::vector<AStarNode*>();
+	num_threads = search->get_options()->removal_threads;
+	parallel_layer_size = search->get_options()->parallel_layer_size;
+	removed = 0;
+	status = SEARCH_RUNNING;
+	cancel_token = search->get_cancel_token();
+}
+
+/*
+* Remove start_pos and every node left without a parent, one depth layer at a
+* time. Nodes removed from the OPEN list are marked for deletion since the heap
+* still holds them, nodes removed from the CLOSED list are deleted once their
+* children have been visited.
+* @return true if the lists were cleared, false if the time limit was reached
+*/
+bool DescendantRemoval::remove_descendants()
+{
+	remove_start();
+
+	while (!layer.empty())
+	{
+		/* The lists are only partly cleared, the caller must not search them */
+		if (cancel_token != NULL && cancel_token->check())
+		{
+			for (unsigned int i = 0; i < layer.size(); i++)
+				delete layer[i];
+			layer.clear();
+			status = SEARCH_TIMEOUT;
+			return false;
+		}
+
+		/* Split a large layer between the threads, the lists are only read meanwhile */
+		unsigned int size = layer.size();
+		unsigned int parts_used = 1;
+		if (num_threads > 1 && size >= parallel_layer_size)
+			parts_used = num_threads;
+		std::vector<LayerPart> parts = std::vector<LayerPart>(parts_used);
+		if (parts_used == 1)
+			visit_layer(0, size, &parts[0]);
+		else
+		{
+			std::vector<std::thread> workers = std::vector<std::thread>();
+			for (unsigned int i = 1; i < parts_used; i++)
+			{
+				workers.push_back(std::thread(
+					&DescendantRemoval::visit_layer, this,
+					size * i / parts_used, size * (i + 1) / parts_used, &parts[i]
+					));
+			}
+			visit_layer(0, size / parts_used, &parts[0]);
+			for (unsigned int i = 0; i < workers.size(); i++)
+				workers[i].join();
+		}
+
+		/* The children of the layer are visited, the next layer replaces it */
+		for (unsigned int i = 0; i < size; i++)
+			delete layer[i];
+		layer.clear();
+
+		for (unsigned int i = 0; i < parts_used; i++)
+		{
+			if (parts[i].missing_child)
+				throw TerminalException("Child of a removed node is in neither A* list.");
+
+			for (unsigned int j = 0; j < parts[i].open_removed.size(); j++)
+			{
+				open_list_hash_table->remove_hash(parts[i].open_removed[j]);
+				parts[i].open_removed[j]->mark_for_deletion();
+			}
+			for (unsigned int j = 0; j < parts[i].closed_removed.size(); j++)
+			{
+				closed_list->remove_hash(parts[i].closed_removed[j]);
+				layer.push_back(parts[i].closed_removed[j]);
+			}
+			removed += parts[i].open_removed.size() + parts[i].closed_removed.size();
+		}
+	}
+
+	status = SEARCH_SOLVED;
+	return true;
+}
+
+/*
+* Remove the start position and detach it from its parents, so the children
+* bitmaps of the nodes left only point at nodes in the lists
+*/
+void DescendantRemoval::remove_start()
+{
+	AStarNode* start = open_list_hash_table->check_duplicate(start_pos);
+	if (start != NULL)
+	{
+		/* An OPEN node has no children */
+		open_list_hash_table->remove_hash(start);
+		start->mark_for_deletion();
+	}
+	else
+	{
+		/* A position the search never generated has no descendants */
+		start = closed_list->check_duplicate(start_pos);
+		if (start == NULL)
+			return;
+		closed_list->remove_hash(start);
+		layer.push_back(start);
+	}
+	removed++;
+
+	/* Every parent of a node is on the CLOSED list */
+	unsigned short parents = start->get_parent_bitmap();
+	for (unsigned short bit = 1; parents != 0; bit = bit << 1)
+	{
+		if ((parents & bit) == 0)
+			continue;
+		parents &= ~bit;
+
+		Position parent_pos =
+			Position(HashStruct::hash_to_coord(bit, start_pos->get_coord()), start_pos->get_depth() - 1);
+		AStarNode* parent = closed_list->check_duplicate(&parent_pos);
+		if (parent != NULL)
+			parent->del_child(start_pos->get_coord());
+	}
+}
+
+/*
+* Visit the children of part of the layer
+* @param begin: Index of the first node of the layer to visit
+* @param end: Index past the last node of the layer to visit
+* @param part: Collects the children left without a parent
+*/
+void DescendantRemoval::visit_layer(unsigned int begin, unsigned int end, LayerPart* part)
+{
+	part->missing_child = false;
+	for (unsigned int i = begin; i < end; i++)
+		visit_children(layer[i], part);
+}
+
+/*
+* Remove one parent from each child of a removed node, collecting the children
+* left without a parent. Other threads may drop other parents of the same
+* children, but exactly one of them sees a child lose its last parent.
+* @param node: A node removed from the CLOSED list
+* @param part: Collects the children left without a parent
+*/
+void DescendantRemoval::visit_children(AStarNode* node, LayerPart* part)
+{
+	Coord* coord = node->get_pos()->get_coord();
+	unsigned short depth = node->get_pos()->get_depth() + 1;
+
+	unsigned short children = node->get_children();
+	for (unsigned short bit = 1; children != 0; bit = bit << 1)
+	{
+		if ((children & bit) == 0)
+			continue;
+		children &= ~bit;
+
+		Position child_pos = Position(HashStruct::hash_to_coord(bit, coord), depth);
+
+		/* A child on the OPEN list has no children of its own */
+		AStarNode* child = open_list_hash_table->check_duplicate(&child_pos);
+		if (child != NULL)
+		{
+			if (child->atomic_del_parent(coord) == 0)
+				part->open_removed.push_back(child);
+			continue;
+		}
+
+		child = closed_list->check_duplicate(&child_pos);
+		if (child == NULL)
+		{
+			part->missing_child = true;
+			continue;
+		}
+
+		/* A CLOSED child left without a parent is in the next layer */
+		if (child->atomic_del_parent(coord) == 0)
+			part->closed_removed.push_back(child);
+	}
+}
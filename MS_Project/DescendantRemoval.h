@@ -0,0 +1,75 @@
+#ifndef DESCENDANTREMOVAL_H
+#define DESCENDANTREMOVAL_H
+
+#include <vector>
+
+#include "SearchStatus.h"
+
+class Agent;
+class AStarNodeList;
+class AStarNode;
+class Position;
+class CancelToken;
+
+/*
+* Removes the descendants of a new constraint from the OPEN and CLOSED lists of
+* an A* search by following the children bitmaps of its nodes. A node is removed
+* once its last parent is, like in PCA*, but each parent to child edge is visited
+* once instead of searching with a heap and a heuristic.
+*
+* Children are one step deeper than their parents, so the removal runs one depth
+* layer at a time. The children of a large layer are visited by several threads
+* that only read the lists and drop parents atomically; the lists are updated
+* between layers.
+*/
+class DescendantRemoval
+{
+public:
+	/* Get the OPEN and CLOSED lists to remove the descendants of start_pos from */
+	DescendantRemoval(Agent* search, Position* start_pos);
+
+	/* Remove start_pos and every node left without a parent, false if the time limit was reached */
+	bool remove_descendants();
+
+	/* Accessor functions */
+	SearchStatus get_status() const { return status; };
+	unsigned long get_removed() const { return removed; };
+private:
+	/* Nodes one thread found left without a parent while visiting part of a layer */
+	struct LayerPart
+	{
+		/* Children on the OPEN list, they have no children of their own */
+		std::vector<AStarNode*> open_removed;
+		/* Children on the CLOSED list, the next layer */
+		std::vector<AStarNode*> closed_removed;
+		/* True if a child was in neither list */
+		bool missing_child;
+	};
+
+	/* OPEN hash table of the A* Search, removed nodes are marked for the heap to delete */
+	AStarNodeList* open_list_hash_table;
+	/* CLOSED hash table of the A* Search, removed nodes are deleted */
+	AStarNodeList* closed_list;
+	/* The constrained position */
+	Position* start_pos;
+	/* Removed CLOSED nodes of one depth whose children have not been visited yet */
+	std::vector<AStarNode*> layer;
+	/* Threads visiting a layer and the fewest nodes a layer needs to use them */
+	unsigned int num_threads;
+	unsigned int parallel_layer_size;
+	/* Number of nodes removed from both lists */
+	unsigned long removed;
+	/* Outcome of the removal, a timed out removal leaves the lists unusable */
+	SearchStatus status;
+	/* Deadline and cancellation flag of the agent's CBS Tree, NULL if there is none */
+	CancelToken* cancel_token;
+
+	/* Remove the start position and detach it from its parents */
+	void remove_start();
+	/* Visit the children of part of the layer */
+	void visit_layer(unsigned int begin, unsigned int end, LayerPart* part);
+	/* Remove one parent from each child of a removed node */
+	void visit_children(AStarNode* node, LayerPart* part);
+};
+
+#endif
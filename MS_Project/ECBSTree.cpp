@@ -0,0 +1,229 @@
+#include <functional>
+
+#include "ECBSTree.h"
+#include "Agent.h"
+#include "CBSNode.h"
+#include "Coordinates.h"
+#include "Macros.h"
+#include "CancelToken.h"
+
+
+/*
+* Compare two CBSNodes by lower bound, ties broken by address so equal nodes stay distinct
+* @param lhs: The first CBSNode to compare
+* @param rhs: The second CBSNode to compare
+* @return true if lhs comes first
+*/
+bool LowerBoundCompare::operator()(const CBSNode* lhs, const CBSNode* rhs) const
+{
+	if (lhs->get_lower_bound() != rhs->get_lower_bound())
+		return lhs->get_lower_bound() < rhs->get_lower_bound();
+	return std::less<const CBSNode*>()(lhs, rhs);
+}
+
+/*
+* Compare two CBSNodes by cost, ties broken by address so equal nodes stay distinct
+* @param lhs: The first CBSNode to compare
+* @param rhs: The second CBSNode to compare
+* @return true if lhs comes first
+*/
+bool CostCompare::operator()(const CBSNode* lhs, const CBSNode* rhs) const
+{
+	if (lhs->get_cost() != rhs->get_cost())
+		return lhs->get_cost() < rhs->get_cost();
+	return std::less<const CBSNode*>()(lhs, rhs);
+}
+
+/*
+* Compare two CBSNodes by number of conflicts, then cost, then address
+* @param lhs: The first CBSNode to compare
+* @param rhs: The second CBSNode to compare
+* @return true if lhs comes first
+*/
+bool ConflictCompare::operator()(const CBSNode* lhs, const CBSNode* rhs) const
+{
+	if (lhs->get_num_conflicts() != rhs->get_num_conflicts())
+		return lhs->get_num_conflicts() < rhs->get_num_conflicts();
+	return CostCompare()(lhs, rhs);
+}
+
+/*
+* Constructor based on files describing the world and agents. The root agents
+* are planned optimally, so the root's cost is also its lower bound.
+* @param agent_file: The name of the file containing each agent
+* @param world_file: The name of the file containing the world
+* @param p_weight: Suboptimality factor, at least 1
+* @param p_options: Configuration of the search, NULL for the defaults of Macros.h
+*/
+ECBSTree::ECBSTree(
+	std::string agent_file, std::string world_file, double p_weight,
+	const SolverOptions* p_options
+	)
+	: CBSTree(agent_file, world_file, p_options)
+{
+	weight = p_weight < 1 ? 1 : p_weight;
+	focal_limit = 0;
+	lower_bound = 0;
+	achieved_bound = 0;
+
+	/* Move the root from the CBSTree's heap onto the OPEN list */
+	while (!tree.empty())
+	{
+		CBSNode* root = pop_node();
+		root->count_conflicts();
+		push_focal(root);
+	}
+}
+
+/*
+* Get a solution costing at most weight times the optimal cost
+* @return the solution CBSNode, NULL if the search stopped without one
+*/
+CBSNode* ECBSTree::search_tree()
+{
+	while (!open.empty())
+	{
+		/* Stop the search early if it was cancelled or ran out of time */
+		if (cancel_token->check())
+		{
+			status = SEARCH_TIMEOUT;
+			return NULL;
+		}
+
+		/* Get the node with the fewest conflicts within the bound */
+		CBSNode* top = pop_focal();
+
+		/* First conflict agent's index and conflict position */
+		int agent_1;
+		Position* conflict_1 = new Position();
+
+		/* Second conflict agent's index and conflict position */
+		int agent_2;
+		Position* conflict_2 = new Position();
+
+		/* Get the conflicts in the node and check if a solution was found */
+		if (!top->get_conflicts(&agent_1, conflict_1, &agent_2, conflict_2))
+		{
+			delete conflict_1;
+			delete conflict_2;
+			achieved_bound = lower_bound == 0 ? 1 :
+				static_cast<double>(top->get_cost()) / lower_bound;
+			return top;
+		}
+
+		/* No solution was found, create two new nodes to add to the lists */
+		generate_focal_child(top, agent_1, conflict_1);
+		generate_focal_child(top, agent_2, conflict_2);
+
+		delete conflict_1;
+		delete conflict_2;
+		delete top;
+
+		/* A focal search ran out of time */
+		if (status == SEARCH_TIMEOUT)
+			return NULL;
+	}
+	/* Out of CBS Nodes */
+	status = SEARCH_INFEASIBLE;
+	return NULL;
+}
+
+/*
+* Push a CBSNode onto the OPEN list, and the FOCAL list if it is within the limit
+* @param node: The CBSNode to push
+*/
+void ECBSTree::push_focal(CBSNode* node)
+{
+	open.insert(node);
+	if (node->get_cost() <= focal_limit)
+		focal.insert(node);
+	else
+		waiting.insert(node);
+}
+
+/*
+* Update the FOCAL limit to weight times the lowest lower bound and pop the
+* CBSNode with the fewest conflicts off of the FOCAL list. The node with the
+* lowest lower bound costs at most weight times that bound, so FOCAL is never empty.
+* @return the CBSNode with the fewest conflicts within the bound
+*/
+CBSNode* ECBSTree::pop_focal()
+{
+	lower_bound = (*open.begin())->get_lower_bound();
+	int new_limit = static_cast<int>(weight * lower_bound + 1e-9);
+
+	/* Move nodes within the new limit onto the FOCAL list */
+	while (!waiting.empty() && (*waiting.begin())->get_cost() <= new_limit)
+	{
+		focal.insert(*waiting.begin());
+		waiting.erase(waiting.begin());
+	}
+
+	/* Move nodes over a lowered limit back off of the FOCAL list */
+	if (new_limit < focal_limit)
+	{
+		for (auto it = focal.begin(); it != focal.end();)
+		{
+			if ((*it)->get_cost() > new_limit)
+			{
+				waiting.insert(*it);
+				it = focal.erase(it);
+			}
+			else
+				it++;
+		}
+	}
+	focal_limit = new_limit;
+
+	CBSNode* top = *focal.begin();
+	focal.erase(focal.begin());
+	open.erase(top);
+	return top;
+}
+
+/*
+* Generate a child CBSNode with a focal search and push it onto the lists,
+* unless its constraint sets equal those of an already generated node
+* @param parent_node: The CBSNode being expanded
+* @param agent_num: The number of the agent who receives the conflict
+* @param conflict: The conflict to add to the agent
+*/
+void ECBSTree::generate_focal_child(CBSNode* parent_node, int agent_num, Position* conflict)
+{
+	/* Skip nodes equal to an already generated node */
+	if (!generated_nodes.insert(CBSNode::child_hash(parent_node, agent_num, conflict)).second)
+	{
+		duplicates++;
+		return;
+	}
+
+	/* Skip nodes whose agent can no longer reach its goal before searching */
+	if (!(*parent_node->get_agents())[agent_num]->can_reach_goal(conflict))
+	{
+		unreachable++;
+		return;
+	}
+
+	/* Only add a node if the agent has a path under its new constraints */
+	CBSNode* add_node = new CBSNode(parent_node, agent_num, conflict, weight);
+	if (add_node->get_status() == SEARCH_SOLVED)
+	{
+		push_focal(add_node);
+		return;
+	}
+
+	/* The whole search stops if the focal search ran out of time */
+	if (add_node->get_status() == SEARCH_TIMEOUT)
+		status = SEARCH_TIMEOUT;
+	delete add_node;
+}
+
+/*
+* Destructor
+*/
+ECBSTree::~ECBSTree()
+{
+	/* Delete all open CBSNodes */
+	for (auto it = open.begin(); it != open.end(); it++)
+		delete *it;
+}
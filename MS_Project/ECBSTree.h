@@ -0,0 +1,78 @@
+#ifndef ECBSTREE_H
+#define ECBSTREE_H
+
+#include <set>
+#include <string>
+
+#include "CBSTree.h"
+
+/* Order CBSNodes by lower bound (the OPEN list of an ECBS search) */
+struct LowerBoundCompare
+{
+	bool operator()(const CBSNode* lhs, const CBSNode* rhs) const;
+};
+
+/* Order CBSNodes by cost (OPEN nodes waiting to enter the FOCAL list) */
+struct CostCompare
+{
+	bool operator()(const CBSNode* lhs, const CBSNode* rhs) const;
+};
+
+/* Order CBSNodes by number of conflicts, then cost (the FOCAL list) */
+struct ConflictCompare
+{
+	bool operator()(const CBSNode* lhs, const CBSNode* rhs) const;
+};
+
+/*
+* Bounded suboptimal CBS (ECBS). Agents are re-planned with a focal search and
+* the high level expands, among the nodes costing at most weight times the
+* lowest lower bound, the node with the fewest conflicts. The solution costs
+* at most weight times the optimal cost.
+*/
+class ECBSTree : public CBSTree
+{
+public:
+	/* Constructor */
+	ECBSTree(
+		std::string agent_file, std::string world_file, double p_weight,
+		const SolverOptions* p_options = NULL
+		);
+
+	/* Accessors */
+	double get_weight() const { return weight; };
+	/* Lower bound on the optimal cost when the solution was found */
+	int get_lower_bound() const { return lower_bound; };
+	/* Ratio of the solution cost to the lower bound, at most weight */
+	double get_achieved_bound() const { return achieved_bound; };
+
+	/* Destructor */
+	virtual ~ECBSTree();
+private:
+	/* Suboptimality factor */
+	double weight;
+	/* Every open CBSNode, ordered by lower bound */
+	std::set<CBSNode*, LowerBoundCompare> open;
+	/* Open CBSNodes costing more than the FOCAL limit */
+	std::set<CBSNode*, CostCompare> waiting;
+	/* Open CBSNodes costing at most the FOCAL limit */
+	std::set<CBSNode*, ConflictCompare> focal;
+	/* Highest cost allowed on the FOCAL list */
+	int focal_limit;
+	/* Lowest lower bound of an open node when the last node was popped */
+	int lower_bound;
+	/* Ratio of the solution cost to the lower bound */
+	double achieved_bound;
+
+	/* Get a solution costing at most weight times the optimal cost */
+	virtual CBSNode* search_tree();
+
+	/* Push a CBSNode onto the OPEN list, and the FOCAL list if it is within the limit */
+	void push_focal(CBSNode* node);
+	/* Pop the CBSNode with the fewest conflicts off of the FOCAL list */
+	CBSNode* pop_focal();
+	/* Generate a child CBSNode with a focal search unless it duplicates a prior node */
+	void generate_focal_child(CBSNode* parent_node, int agent_num, Position* conflict);
+};
+
+#endif
@@ -0,0 +1,223 @@
+#include <climits>
+
+#include "FocalSearch.h"
+#include "Agent.h"
+#include "World.h"
+#include "HashStruct.h"
+#include "Exceptions.h"
+#include "CancelToken.h"
+#include "ReservationTable.h"
+
+/*
+* Constructor
+* @param p_pos: Position of the node
+* @param p_parent: Index of the parent node, -1 for the start node
+* @param p_conflicts: Conflicts along the path to the node
+* @param p_cost: Depth plus heuristic of the node
+*/
+FocalNode::FocalNode(Position* p_pos, int p_parent, int p_conflicts, int p_cost)
+{
+	pos = *p_pos;
+	parent = p_parent;
+	conflicts = p_conflicts;
+	cost = p_cost;
+	closed = false;
+}
+
+/*
+* Constructor
+* @param search: The agent to find a path for (its constraints are respected)
+* @param p_weight: Suboptimality factor, at least 1
+* @param p_others: Paths of the other agents, NULL if there are none
+*/
+FocalSearch::FocalSearch(Agent* search, double p_weight, ReservationTable* p_others)
+{
+	world = search->get_world();
+	start = search->get_start();
+	goal = search->get_goal();
+	constraints = search->get_constraints();
+	others = p_others;
+	reserved = NULL;
+	max_depth = -1;
+	min_goal_depth = 0;
+	weight = p_weight < 1 ? 1 : p_weight;
+	status = SEARCH_RUNNING;
+
+	focal_limit = -1;
+	lower_bound = 0;
+	conflicts = 0;
+
+	cancel_token = search->get_cancel_token();
+}
+
+/*
+* Search for a path. The OPEN list is ordered by cost and the FOCAL list holds
+* every OPEN node costing at most weight times the cheapest OPEN node.
+* @return true if a path was found, false if the agent has no path or the time
+* limit was reached (see get_status)
+*/
+bool FocalSearch::focal_search()
+{
+	/* Place the start node on the OPEN list */
+	Position start_pos = Position(start, 0);
+	nodes.push_back(FocalNode(&start_pos, -1, 0, start->moves_to(goal)));
+	node_index.emplace(HashStruct::hash_pos(&start_pos), 0);
+	open_node(0);
+
+	while (!open_list.empty())
+	{
+		/* Make sure the search has not been cancelled or run out of time */
+		if (cancel_token != NULL && cancel_token->poll())
+		{
+			status = SEARCH_TIMEOUT;
+			return false;
+		}
+
+		/* The cheapest OPEN node bounds the cost of any path */
+		int min_cost = open_list.begin()->first;
+		raise_focal_limit(static_cast<int>(weight * min_cost + 1e-9));
+
+		/* Expand the FOCAL node with the fewest conflicts */
+		int top = std::get<3>(*focal_list.begin());
+		focal_list.erase(focal_list.begin());
+		open_list.erase(std::make_pair(nodes[top].get_cost(), top));
+		nodes[top].close();
+
+		/* Check if the node is a solution */
+		if (
+			*nodes[top].get_pos()->get_coord() == *goal &&
+			nodes[top].get_pos()->get_depth() >= min_goal_depth
+			)
+		{
+			lower_bound = min_cost;
+			conflicts = nodes[top].get_conflicts();
+			trace_path(top);
+			status = SEARCH_SOLVED;
+			return true;
+		}
+
+		/* Positions past the depth limit are not searched */
+		if (max_depth != -1 && nodes[top].get_pos()->get_depth() >= max_depth)
+			continue;
+
+		/* Generate every move, including waiting in place */
+		unsigned short x_coord = nodes[top].get_pos()->get_x_coord();
+		unsigned short y_coord = nodes[top].get_pos()->get_y_coord();
+		for (int x_diff = -1; x_diff <= 1; x_diff++)
+		{
+			for (int y_diff = -1; y_diff <= 1; y_diff++)
+			{
+				/* Coordinates must be non-negative */
+				if ((x_coord == 0 && x_diff < 0) || (y_coord == 0 && y_diff < 0))
+					continue;
+				generate(top, x_coord + x_diff, y_coord + y_diff);
+			}
+		}
+	}
+
+	/* The agent has no path under its constraints */
+	status = SEARCH_INFEASIBLE;
+	return false;
+}
+
+/*
+* Generate a successor of a node, keeping the path with the fewest conflicts
+* if the successor was already generated
+* @param parent: Index of the node being expanded
+* @param x_coord: X coordinate of the successor
+* @param y_coord: Y coordinate of the successor
+*/
+void FocalSearch::generate(int parent, unsigned short x_coord, unsigned short y_coord)
+{
+	Position succ = Position(x_coord, y_coord, nodes[parent].get_pos()->get_depth() + 1);
+
+	/* Skip obstacles and constrained positions */
+	if (!world->check_coord(succ.get_coord()))
+		return;
+	unsigned int hash = HashStruct::hash_pos(&succ);
+	if (constraints->find(hash) != constraints->end())
+		return;
+	if (reserved != NULL && reserved->count_move(nodes[parent].get_pos()->get_coord(), &succ) > 0)
+		return;
+
+	/* Conflicts with other agents along the path through the parent */
+	int succ_conflicts = nodes[parent].get_conflicts();
+	if (others != NULL)
+		succ_conflicts += others->count_move(nodes[parent].get_pos()->get_coord(), &succ);
+
+	auto it = node_index.find(hash);
+	if (it == node_index.end())
+	{
+		/* New node */
+		int cost = succ.get_depth() + succ.get_coord()->moves_to(goal);
+		nodes.push_back(FocalNode(&succ, parent, succ_conflicts, cost));
+		node_index.emplace(hash, nodes.size() - 1);
+		open_node(nodes.size() - 1);
+		return;
+	}
+
+	/* Every path to a position has the same depth, keep the one with fewer conflicts */
+	int index = it->second;
+	if (nodes[index].is_closed() || nodes[index].get_conflicts() <= succ_conflicts)
+		return;
+
+	bool in_focal = nodes[index].get_cost() <= focal_limit;
+	if (in_focal)
+		focal_list.erase(focal_key(index));
+	nodes[index].set_parent(parent);
+	nodes[index].set_conflicts(succ_conflicts);
+	if (in_focal)
+		focal_list.insert(focal_key(index));
+}
+
+/*
+* Add a node to the OPEN list, and to the FOCAL list if it is within the limit
+* @param index: Index of the node
+*/
+void FocalSearch::open_node(int index)
+{
+	open_list.insert(std::make_pair(nodes[index].get_cost(), index));
+	if (nodes[index].get_cost() <= focal_limit)
+		focal_list.insert(focal_key(index));
+}
+
+/*
+* Raise the FOCAL limit. The heuristic is consistent so the cheapest OPEN cost
+* never decreases, and the limit only has to move up.
+* @param new_limit: The new highest cost allowed on the FOCAL list
+*/
+void FocalSearch::raise_focal_limit(int new_limit)
+{
+	if (new_limit <= focal_limit)
+		return;
+
+	auto it = open_list.lower_bound(std::make_pair(focal_limit + 1, INT_MIN));
+	for (; it != open_list.end() && it->first <= new_limit; it++)
+		focal_list.insert(focal_key(it->second));
+
+	focal_limit = new_limit;
+}
+
+/*
+* Trace the path back from the goal node
+* @param goal_index: Index of the goal node
+*/
+void FocalSearch::trace_path(int goal_index)
+{
+	for (int i = goal_index; i != -1; i = nodes[i].get_parent())
+		path.push(*nodes[i].get_pos()->get_coord());
+}
+
+/*
+* Key of a node on the FOCAL list. Ties in conflicts go to the cheaper node,
+* then the deeper node which is closer to the goal.
+* @param index: Index of the node
+* @return the key ordering the FOCAL list
+*/
+std::tuple<int, int, int, int> FocalSearch::focal_key(int index)
+{
+	return std::make_tuple(
+		nodes[index].get_conflicts(), nodes[index].get_cost(),
+		-static_cast<int>(nodes[index].get_pos()->get_depth()), index
+		);
+}
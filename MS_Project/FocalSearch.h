@@ -0,0 +1,133 @@
+#ifndef FOCALSEARCH_H
+#define FOCALSEARCH_H
+
+#include <set>
+#include <tuple>
+#include <stack>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+#include "Macros.h"
+#include "Coordinates.h"
+#include "SearchStatus.h"
+
+class Agent;
+class CancelToken;
+class World;
+class ReservationTable;
+
+/*
+* A node of a focal search: a position, the number of conflicts with other
+* agents along the best path found to it, and the index of its parent node
+*/
+class FocalNode
+{
+public:
+	/* Constructor */
+	FocalNode(Position* p_pos, int p_parent, int p_conflicts, int p_cost);
+
+	/* Set functions */
+	void set_parent(int p_parent) { parent = p_parent; };
+	void set_conflicts(int p_conflicts) { conflicts = p_conflicts; };
+	void close() { closed = true; };
+
+	/* Accessors */
+	Position* get_pos() { return &pos; };
+	int get_parent() const { return parent; };
+	int get_conflicts() const { return conflicts; };
+	int get_cost() const { return cost; };
+	bool is_closed() const { return closed; };
+private:
+	/* Position of the node */
+	Position pos;
+	/* Index of the parent node, -1 for the start node */
+	int parent;
+	/* Conflicts with other agents along the path to this node */
+	int conflicts;
+	/* Depth plus the heuristic */
+	int cost;
+	/* True once the node has been expanded */
+	bool closed;
+};
+
+/*
+* Bounded suboptimal low level search for one agent. Nodes on the OPEN list
+* whose cost is within a factor (weight) of the cheapest OPEN node form the
+* FOCAL list, which is expanded in order of fewest conflicts with the paths
+* of the other agents. The path found costs at most weight times the lower bound.
+*/
+class FocalSearch
+{
+public:
+	/* Constructor, others may be NULL if no other paths should be avoided */
+	FocalSearch(Agent* search, double p_weight, ReservationTable* p_others);
+
+	/* Search for a path, return false if the agent has no path */
+	bool focal_search();
+
+	/* Forbid every move into space reserved by other agents */
+	void set_reservations(ReservationTable* p_reserved) { reserved = p_reserved; };
+	/* Do not search past a depth, -1 for no limit but SEARCH_DEPTH */
+	void set_max_depth(int p_max_depth) { max_depth = p_max_depth; };
+	/* Only accept the goal from a depth on (e.g. to stay there for good) */
+	void set_min_goal_depth(int p_min_goal_depth) { min_goal_depth = p_min_goal_depth; };
+
+	/* Accessors */
+	std::stack<Coord>* get_path() { return &path; };
+	int get_lower_bound() const { return lower_bound; };
+	int get_conflicts() const { return conflicts; };
+	SearchStatus get_status() const { return status; };
+private:
+	/* Outcome of the search */
+	SearchStatus status;
+	/* Pointer to the world of agents */
+	World* world;
+	/* Start and goal coordinates of the agent */
+	Coord* start;
+	Coord* goal;
+	/* Constraints of the agent */
+	std::unordered_map<unsigned int, Position>* constraints;
+	/* Paths of the other agents, avoided when possible */
+	ReservationTable* others;
+	/* Paths of the other agents, never entered */
+	ReservationTable* reserved;
+	/* Deepest position searched, -1 for no limit */
+	int max_depth;
+	/* Shallowest depth at which the goal is accepted */
+	int min_goal_depth;
+	/* Suboptimality factor */
+	double weight;
+
+	/* Every node generated, referenced by index */
+	std::vector<FocalNode> nodes;
+	/* Index of the node at each position */
+	std::unordered_map<unsigned int, int> node_index;
+	/* OPEN list ordered by (cost, node index) */
+	std::set<std::pair<int, int> > open_list;
+	/* FOCAL list ordered by (conflicts, cost, -depth, node index) */
+	std::set<std::tuple<int, int, int, int> > focal_list;
+	/* Highest cost allowed on the FOCAL list */
+	int focal_limit;
+
+	/* Solution path, lower bound on the optimal cost and conflicts of the path */
+	std::stack<Coord> path;
+	int lower_bound;
+	int conflicts;
+
+	/* Deadline and cancellation flag of the agent's CBS Tree, NULL if there is none */
+	CancelToken* cancel_token;
+
+	/* Add a node to the OPEN list, and to the FOCAL list if it is within the limit */
+	void open_node(int index);
+	/* Raise the FOCAL limit, moving newly eligible OPEN nodes onto the FOCAL list */
+	void raise_focal_limit(int new_limit);
+	/* Generate a successor of a node */
+	void generate(int parent, unsigned short x_coord, unsigned short y_coord);
+	/* Trace the path back from the goal node */
+	void trace_path(int goal_index);
+	/* Key of a node on the FOCAL list */
+	std::tuple<int, int, int, int> focal_key(int index);
+};
+
+#endif
@@ -79,6 +79,16 @@ unsigned int HashStruct::hash_coord(Coord* key)
 	return std::hash<unsigned int>()(hash_val);
 }
 
+/*
+* Pack a coordinate into a single key
+* @param key: The coordinate
+* @return a key unique to the coordinate
+*/
+unsigned int HashStruct::coord_key(Coord* key)
+{
+	return (static_cast<unsigned int>(key->get_xcoord()) << 16) | key->get_ycoord();
+}
+
 /*
 * Hash function based on a comparison of two coordinates
 * @param main: The main coordinate to compare
@@ -162,4 +172,55 @@ Coord HashStruct::hash_to_coord(unsigned short hash, Coord* comp_coord)
 		return Coord(x_coord + 1, y_coord + 1);
 	else
 		throw TerminalException("Bad hash value when converting back to Coord.");
+}
+
+/*
+* Hash a single constraint for use in a constraint set hash
+* @param key: The constrained position
+* @return a 64 bit hash of the position's coordinates and depth
+*/
+unsigned long long HashStruct::hash_constraint(Position* key)
+{
+	/* Pack the coordinates and depth into disjoint bits before mixing */
+	unsigned long long packed = key->get_x_coord();
+	packed = (packed << 16) | key->get_y_coord();
+	packed = (packed << 16) | key->get_depth();
+
+	return mix(packed);
+}
+
+/*
+* Hash a positive constraint (landmark), which differs from the hash of the
+* negative constraint on the same position
+* @param key: The position the agent must occupy
+* @return a 64 bit hash of the landmark
+*/
+unsigned long long HashStruct::hash_landmark(Position* key)
+{
+	return mix(hash_constraint(key));
+}
+
+/*
+* Hash an agent's constraint set together with the agent's index, so equal
+* constraint sets on different agents contribute differently to a CBSNode hash
+* @param agent_num: The index of the agent in the CBSNode
+* @param set_hash: The hash of the agent's constraint set
+* @return a 64 bit hash of the pair
+*/
+unsigned long long HashStruct::hash_agent_constraints(int agent_num, unsigned long long set_hash)
+{
+	return mix(set_hash ^ mix(static_cast<unsigned long long>(agent_num) + 1));
+}
+
+/*
+* Scramble the bits of a 64 bit key (splitmix64 finalizer)
+* @param key: The key to scramble
+* @return a well distributed 64 bit hash of key
+*/
+unsigned long long HashStruct::mix(unsigned long long key)
+{
+	key += 0x9e3779b97f4a7c15ULL;
+	key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+	return key ^ (key >> 31);
 }
\ No newline at end of file
@@ -9,11 +9,22 @@ struct HashStruct
 	/* Hashing functions for Positions and Coords */
 	static unsigned int hash_pos(Position* key);
 	static unsigned int hash_coord(Coord* key);
+	/* Pack a coordinate into a key, unique for any pair of 16 bit coordinates */
+	static unsigned int coord_key(Coord* key);
 	static unsigned short hash_coord_comp(Coord* main, Coord* comp);
 
 	/* Convert a Coord comparison hash back to a Coord */
 	static Coord hash_to_coord(unsigned short hash, Coord* comp_coord);
 
+	/*
+	* 64 bit hashes for sets of constraints. Set hashes are the XOR of their
+	* members' hashes so they can be updated one constraint at a time.
+	*/
+	static unsigned long long hash_constraint(Position* key);
+	static unsigned long long hash_landmark(Position* key);
+	static unsigned long long hash_agent_constraints(int agent_num, unsigned long long set_hash);
+	static unsigned long long mix(unsigned long long key);
+
 	/* Binary values where the first 11 and 10 digits, respectively, are all 1s */
 	static const unsigned int ELEVEN;
 	static const unsigned int TEN;
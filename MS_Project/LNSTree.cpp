@@ -0,0 +1,246 @@
+#include <cstdlib>
+#include <algorithm>
+
+#include "LNSTree.h"
+#include "CBSNode.h"
+#include "Agent.h"
+#include "World.h"
+#include "PrioritizedPlanner.h"
+#include "CancelToken.h"
+
+
+/* Default number of agents re-solved at once */
+static const int DEFAULT_NEIGHBORHOOD_SIZE = 4;
+/* Default number of neighborhoods tried when there is no time limit */
+static const int DEFAULT_ITERATIONS = 1000;
+/* CBSNodes a neighborhood may expand before it is given up */
+static const int NEIGHBORHOOD_EXPANSIONS = 1000;
+
+/*
+* Constrain an agent so it can neither meet nor swap places with an agent
+* following a fixed path. Swaps are constrained the way CBS resolves them,
+* on the coordinate the fixed agent leaves.
+* @param agent: The agent to constrain
+* @param path: The fixed path
+*/
+static void constrain_around(Agent* agent, std::stack<Coord> path)
+{
+	Coord prev_coord = path.top();
+	path.pop();
+	unsigned short depth = 0;
+
+	while (!path.empty())
+	{
+		Coord curr_coord = path.top();
+		path.pop();
+		depth++;
+
+		Position vertex = Position(curr_coord, depth);
+		agent->add_conflict(&vertex);
+		if (prev_coord != curr_coord)
+		{
+			Position swap = Position(prev_coord, depth);
+			agent->add_conflict(&swap);
+		}
+
+		prev_coord = curr_coord;
+	}
+}
+
+/*
+* Constructor based on files describing the world and agents
+* @param agent_file: The name of the file containing each agent
+* @param world_file: The name of the file containing the world
+* @param p_options: Configuration of the search, NULL for the defaults of Macros.h
+*/
+LNSTree::LNSTree(std::string agent_file, std::string world_file, const SolverOptions* p_options)
+	: CBSTree(agent_file, world_file, p_options)
+{
+	neighborhood_size = DEFAULT_NEIGHBORHOOD_SIZE;
+	if (options.time_limit > 0)
+		max_iterations = 0;
+	else
+		max_iterations = DEFAULT_ITERATIONS;
+	iterations = 0;
+	improvements = 0;
+	cost = 0;
+	sum_of_costs = 0;
+
+	/*
+	* No plan can finish before the longest individual shortest path, the cost of the
+	* root whose agents are searched without constraints
+	*/
+	lower_bound = 0;
+	if (!tree.empty())
+		lower_bound = tree.front()->get_cost();
+}
+
+/*
+* Find a plan by prioritized planning and improve it until the time limit.
+* If prioritized planning leaves an agent without a path, the plain CBS
+* search is used instead.
+* @return a CBSNode holding the best plan found
+*/
+CBSNode* LNSTree::search_tree()
+{
+	/* Agents leave the world at their goal, as they do in CBS solutions */
+	PrioritizedPlanner planner = PrioritizedPlanner(&agents);
+	planner.set_park_at_goal(false);
+	if (!planner.plan())
+		return CBSTree::search_tree();
+	set_plan(planner.get_paths());
+
+	/* A neighborhood that runs out of time stops the search, the best plan is kept */
+	while (cost > lower_bound && time_left() && status != SEARCH_TIMEOUT)
+	{
+		std::vector<int> neighborhood = std::vector<int>();
+		choose_neighborhood(&neighborhood);
+		iterations++;
+		if (improve(&neighborhood))
+			improvements++;
+	}
+
+	return plan_node(&plan);
+}
+
+/*
+* Check if another neighborhood may be tried
+* @return true if neither the iteration limit nor the time limit was reached
+*/
+bool LNSTree::time_left()
+{
+	if (max_iterations != 0 && iterations >= max_iterations)
+		return false;
+	return !cancel_token->check();
+}
+
+/*
+* Choose the agents to re-solve. The makespan can only drop if an agent
+* setting it is re-solved, so one of them is always included.
+* @param neighborhood: Vector the agent numbers are added to
+*/
+void LNSTree::choose_neighborhood(std::vector<int>* neighborhood)
+{
+	int num_agents = agents.size();
+
+	/* Pick one of the agents setting the makespan */
+	std::vector<int> critical = std::vector<int>();
+	for (int i = 0; i < num_agents; i++)
+	{
+		if (static_cast<int>(plan[i].size()) - 1 == cost)
+			critical.push_back(i);
+	}
+	neighborhood->push_back(critical[rand() % critical.size()]);
+
+	/* Fill the rest of the neighborhood with random agents */
+	int size = std::min(neighborhood_size, num_agents);
+	while (static_cast<int>(neighborhood->size()) < size)
+	{
+		int agent_num = rand() % num_agents;
+		if (std::find(neighborhood->begin(), neighborhood->end(), agent_num) == neighborhood->end())
+			neighborhood->push_back(agent_num);
+	}
+}
+
+/*
+* Re-solve a neighborhood with CBS around the fixed paths of every other agent.
+* The new plan is kept unless it is worse than the best plan.
+* @param neighborhood: The agents to re-solve
+* @return true if the plan improved
+*/
+bool LNSTree::improve(std::vector<int>* neighborhood)
+{
+	int num_agents = agents.size();
+	int size = neighborhood->size();
+
+	/* Create new agents constrained around every agent outside the neighborhood */
+	std::vector<Agent*> sub_agents = std::vector<Agent*>();
+	for (int i = 0; i < size; i++)
+	{
+		Agent* fixed_agent = agents[(*neighborhood)[i]];
+		Agent* sub_agent = new Agent(
+			fixed_agent->get_start(), fixed_agent->get_goal(), world,
+			fixed_agent->get_name(), cancel_token, &options
+			);
+		for (int j = 0; j < num_agents; j++)
+		{
+			if (std::find(neighborhood->begin(), neighborhood->end(), j) == neighborhood->end())
+				constrain_around(sub_agent, plan[j]);
+		}
+		sub_agents.push_back(sub_agent);
+	}
+
+	/*
+	* Fixed agents leave the world at their goal, so every agent has a path.
+	* Solve them now so the tree below is not built around a failed search.
+	*/
+	for (int i = 0; i < size; i++)
+	{
+		SearchStatus agent_status = sub_agents[i]->solve();
+		if (agent_status != SEARCH_SOLVED)
+		{
+			for (int j = 0; j < size; j++)
+				delete sub_agents[j];
+			if (agent_status == SEARCH_TIMEOUT)
+				status = SEARCH_TIMEOUT;
+			return false;
+		}
+	}
+
+	/* Re-solve the neighborhood, giving up if it takes too long */
+	std::vector<std::stack<Coord> > new_plan = plan;
+	{
+		CBSTree sub_tree = CBSTree(world, &sub_agents);
+		sub_tree.set_expansion_limit(NEIGHBORHOOD_EXPANSIONS);
+
+		CBSNode* solution = sub_tree.solve();
+		if (solution == NULL)
+		{
+			if (sub_tree.get_status() == SEARCH_TIMEOUT)
+				status = SEARCH_TIMEOUT;
+			return false;
+		}
+
+		for (int i = 0; i < size; i++)
+			new_plan[(*neighborhood)[i]] = (*solution->get_agents())[i]->get_solution();
+		delete solution;
+	}
+
+	/* Keep the new plan unless it is worse */
+	int old_cost = cost;
+	int old_sum_of_costs = sum_of_costs;
+	int new_cost = 0;
+	int new_sum_of_costs = 0;
+	for (int i = 0; i < num_agents; i++)
+	{
+		int agent_cost = new_plan[i].size() - 1;
+		new_sum_of_costs += agent_cost;
+		if (agent_cost > new_cost)
+			new_cost = agent_cost;
+	}
+	if (new_cost > old_cost || (new_cost == old_cost && new_sum_of_costs > old_sum_of_costs))
+		return false;
+
+	set_plan(&new_plan);
+	return new_cost < old_cost || new_sum_of_costs < old_sum_of_costs;
+}
+
+/*
+* Set the plan and its makespan and sum of costs
+* @param new_plan: One path per agent
+*/
+void LNSTree::set_plan(std::vector<std::stack<Coord> >* new_plan)
+{
+	plan = *new_plan;
+
+	cost = 0;
+	sum_of_costs = 0;
+	int num_agents = plan.size();
+	for (int i = 0; i < num_agents; i++)
+	{
+		int agent_cost = plan[i].size() - 1;
+		sum_of_costs += agent_cost;
+		if (agent_cost > cost)
+			cost = agent_cost;
+	}
+}
@@ -0,0 +1,62 @@
+#ifndef LNSTREE_H
+#define LNSTREE_H
+
+#include <vector>
+#include <stack>
+#include <string>
+
+#include "CBSTree.h"
+#include "Coordinates.h"
+
+/*
+* Anytime MAPF by large neighborhood search. A quick feasible plan is found by
+* prioritized planning, then small neighborhoods of agents are re-solved with
+* CBS around the fixed paths of every other agent. The best plan found so far
+* is returned when the time limit is reached instead of failing.
+*/
+class LNSTree : public CBSTree
+{
+public:
+	/* Constructor */
+	LNSTree(std::string agent_file, std::string world_file, const SolverOptions* p_options = NULL);
+	/* Number of agents re-solved at once */
+	void set_neighborhood_size(int p_neighborhood_size) { neighborhood_size = p_neighborhood_size; };
+	/* Number of neighborhoods tried when there is no time limit */
+	void set_max_iterations(int p_max_iterations) { max_iterations = p_max_iterations; };
+
+	/* Accessors */
+	/* Cost of the best plan */
+	int get_cost() const { return cost; };
+	/* Lower bound on the optimal cost (the longest individual shortest path) */
+	int get_lower_bound() const { return lower_bound; };
+	int get_iterations() const { return iterations; };
+	int get_improvements() const { return improvements; };
+private:
+	/* Best plan found so far, one path per agent */
+	std::vector<std::stack<Coord> > plan;
+	/* Makespan and sum of costs of the best plan */
+	int cost;
+	int sum_of_costs;
+	/* Lower bound on the optimal cost */
+	int lower_bound;
+	/* Number of agents re-solved at once */
+	int neighborhood_size;
+	/* Number of neighborhoods tried when there is no time limit */
+	int max_iterations;
+	/* Number of neighborhoods tried, and the number that improved the plan */
+	int iterations;
+	int improvements;
+
+	/* Improve a plan until the time limit, return the best plan found */
+	virtual CBSNode* search_tree();
+	/* True while the time limit (or the iteration limit) allows another neighborhood */
+	bool time_left();
+	/* Choose the agents to re-solve, always including an agent setting the makespan */
+	void choose_neighborhood(std::vector<int>* neighborhood);
+	/* Re-solve a neighborhood with CBS, keep the result if it is no worse */
+	bool improve(std::vector<int>* neighborhood);
+	/* Set the plan and its makespan and sum of costs */
+	void set_plan(std::vector<std::stack<Coord> >* new_plan);
+};
+
+#endif
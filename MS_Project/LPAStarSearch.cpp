@@ -0,0 +1,500 @@
+#include <climits>
+
+#include "LPAStarSearch.h"
+#include "Agent.h"
+#include "World.h"
+#include "HashStruct.h"
+#include "CancelToken.h"
+#include "Exceptions.h"
+
+/* Cost of an unreachable state */
+static const unsigned short INFINITE_COST = USHRT_MAX;
+
+/* Live and peak state counts across every search */
+unsigned long LPAStarSearch::live_count = 0;
+unsigned long LPAStarSearch::peak_count = 0;
+
+/*
+* Start a search from the start of an agent
+* @param search: The agent to search for, it holds the constraints and the depth bound
+*/
+LPAStarSearch::LPAStarSearch(Agent* search)
+{
+	world = search->get_world();
+	goal = search->get_goal();
+	start = search->get_start();
+	depth_bound = search->get_depth_bound();
+	constraints = search->get_constraints();
+	cancel_token = search->get_cancel_token();
+
+	states = std::unordered_map<unsigned int, LPAState>();
+	goal_states = std::vector<unsigned int>();
+	queue = std::priority_queue<LPAEntry, std::vector<LPAEntry>, LPAEntryGreater>();
+
+	/* Nothing reaches the goal yet */
+	sink.g = INFINITE_COST;
+	sink.rhs = INFINITE_COST;
+	sink.queued = false;
+
+	/* The start is the only state whose rhs is not computed from predecessors */
+	Position start_pos = Position(*start, 0);
+	update_vertex(&start_pos);
+}
+
+/*
+* Copy the search of a pre-existing agent for one of its children. States the
+* earlier constraints cut off are left behind, an unreached state is the same as
+* a missing one. A child may search deeper than its parent, so the states at the
+* old depth bound get successors.
+* @param copy: The search of the pre-existing agent
+* @param search: The child agent, it holds the constraints and the depth bound
+*/
+LPAStarSearch::LPAStarSearch(LPAStarSearch* copy, Agent* search)
+{
+	world = search->get_world();
+	goal = search->get_goal();
+	start = search->get_start();
+	depth_bound = search->get_depth_bound();
+	constraints = search->get_constraints();
+	cancel_token = search->get_cancel_token();
+
+	states = std::unordered_map<unsigned int, LPAState>();
+	states.reserve(copy->states.size());
+	goal_states = std::vector<unsigned int>();
+	for (auto it = copy->states.begin(); it != copy->states.end(); it++)
+	{
+		if (it->second.g == INFINITE_COST && it->second.rhs == INFINITE_COST)
+			continue;
+		states.emplace(it->first, it->second);
+		if (it->second.x == goal->get_xcoord() && it->second.y == goal->get_ycoord())
+			goal_states.push_back(it->first);
+	}
+	sink = copy->sink;
+	rebuild_queue();
+
+	live_count += states.size();
+	if (live_count > peak_count)
+		peak_count = live_count;
+
+	/* New edges leave the reachable states at the old bound */
+	if (depth_bound > copy->depth_bound)
+	{
+		std::vector<Position> frontier = std::vector<Position>();
+		for (auto it = states.begin(); it != states.end(); it++)
+		{
+			if (it->second.depth != copy->depth_bound || it->second.g == INFINITE_COST)
+				continue;
+			Position pos = Position(it->second.x, it->second.y, it->second.depth);
+			if (!(*pos.get_coord() == *goal))
+				frontier.push_back(pos);
+		}
+		for (unsigned int i = 0; i < frontier.size(); i++)
+		{
+			std::vector<Position> successors = std::vector<Position>();
+			get_neighbours(&frontier[i], 1, &successors);
+			for (unsigned int j = 0; j < successors.size(); j++)
+				update_vertex(&successors[j]);
+		}
+	}
+}
+
+/*
+* Block a newly constrained position. The position loses its predecessors,
+* so it is queued if it was reached.
+* @param constraint: The constrained position, already one of the agent's constraints
+*/
+void LPAStarSearch::add_constraint(Position* constraint)
+{
+	update_vertex(constraint);
+}
+
+/*
+* Search until the earliest arrival at the goal is consistent
+* @return SEARCH_SOLVED if the goal is reachable, SEARCH_INFEASIBLE if it is not
+* below the depth bound, SEARCH_TIMEOUT if the search was stopped
+*/
+SearchStatus LPAStarSearch::compute_shortest_path()
+{
+	while (!queue.empty() && (top_before_sink() || sink.rhs != sink.g))
+	{
+		/* Make sure the search has not been cancelled or run out of time */
+		if (cancel_token != NULL && cancel_token->poll())
+			return SEARCH_TIMEOUT;
+
+		LPAEntry top = queue.top();
+		queue.pop();
+
+		if (top.sink)
+		{
+			if (!sink.queued || sink.key_1 != top.key_1 || sink.key_2 != top.key_2)
+				continue;
+			sink.queued = false;
+
+			/* The sink has no successors, it only becomes consistent */
+			if (sink.g > sink.rhs)
+				sink.g = sink.rhs;
+			else
+			{
+				sink.g = INFINITE_COST;
+				update_sink();
+			}
+			continue;
+		}
+
+		Position pos = Position(top.x, top.y, top.depth);
+		auto found = states.find(HashStruct::hash_pos(&pos));
+		if (found == states.end())
+			continue;
+		LPAState* state = &found->second;
+
+		/* Skip an entry the state was queued again after */
+		if (!state->queued || state->key_1 != top.key_1 || state->key_2 != top.key_2)
+			continue;
+		state->queued = false;
+		Agent::count_expansion();
+
+		bool overconsistent = state->g > state->rhs;
+		if (overconsistent)
+			state->g = state->rhs;
+		else
+		{
+			/* The state lost its predecessors, so it and its successors are searched again */
+			state->g = INFINITE_COST;
+			update_vertex(&pos);
+		}
+
+		/* Agents vanish at their goal, a goal state only leads to the sink */
+		if (*pos.get_coord() == *goal)
+		{
+			update_sink();
+			continue;
+		}
+
+		std::vector<Position> successors = std::vector<Position>();
+		get_neighbours(&pos, 1, &successors);
+		for (unsigned int i = 0; i < successors.size(); i++)
+			update_vertex(&successors[i]);
+	}
+
+	if (sink.g == INFINITE_COST || sink.g != sink.rhs)
+		return SEARCH_INFEASIBLE;
+	return SEARCH_SOLVED;
+}
+
+/*
+* Get the solution path by following reached predecessors back from the
+* earliest goal state
+* @return the path, the start at the top of the stack
+*/
+std::stack<Coord> LPAStarSearch::get_path()
+{
+	std::stack<Coord> path = std::stack<Coord>();
+
+	/* The goal state the sink's cost comes from */
+	Position pos = Position(*goal, sink.g);
+	path.push(*pos.get_coord());
+
+	while (pos.get_depth() > 0)
+	{
+		std::vector<Position> predecessors = std::vector<Position>();
+		get_neighbours(&pos, -1, &predecessors);
+
+		/* Only a consistent predecessor is still reachable */
+		unsigned int i = 0;
+		while (i < predecessors.size() && !on_path(&predecessors[i]))
+			i++;
+		if (i == predecessors.size())
+			throw TerminalException("LPA* path has no reached predecessor.");
+
+		pos = predecessors[i];
+		path.push(*pos.get_coord());
+	}
+	return path;
+}
+
+/*
+* Check if a reachable state lies at the depth bound
+* @return true if one does, its successors were never searched
+*/
+bool LPAStarSearch::get_reached_bound()
+{
+	for (auto it = states.begin(); it != states.end(); it++)
+	{
+		if (it->second.depth == depth_bound && it->second.g != INFINITE_COST)
+			return true;
+	}
+	return false;
+}
+
+/*
+* Search the successors of a position, or its predecessors. Neither may be
+* blocked, states deeper than the depth bound have no predecessors and states
+* of the goal cell are not predecessors since agents vanish at their goal.
+* @param pos: The position whose neighbours are found
+* @param depth_change: 1 for the successors, -1 for the predecessors
+* @param neighbours: Vector the neighbours are appended to
+*/
+void LPAStarSearch::get_neighbours(Position* pos, int depth_change, std::vector<Position>* neighbours)
+{
+	int depth = pos->get_depth() + depth_change;
+	if (depth < 0 || (depth_change > 0 && pos->get_depth() >= depth_bound))
+		return;
+
+	/*
+	* Number of possible neighbours, in the order of the parent bitmap of A* Nodes
+	* so the path follows the predecessor the A* Search would
+	*/
+	const int NUM_NEIGHBOURS = 9;
+	const int X_MOVES[NUM_NEIGHBOURS] = { -1, -1, -1, 0, 0, 0, 1, 1, 1 };
+	const int Y_MOVES[NUM_NEIGHBOURS] = { -1, 0, 1, -1, 0, 1, -1, 0, 1 };
+
+	for (int i = 0; i < NUM_NEIGHBOURS; i++)
+	{
+		Position neighbour = Position(
+			pos->get_x_coord() + X_MOVES[i], pos->get_y_coord() + Y_MOVES[i], depth
+			);
+		if (blocked(&neighbour))
+			continue;
+		if (depth_change < 0 && *neighbour.get_coord() == *goal)
+			continue;
+		neighbours->push_back(neighbour);
+	}
+}
+
+/*
+* Check if a position cannot be occupied
+* @param pos: The position to check
+* @return true if it is outside the world, an obstacle or constrained. Like the
+* root of the A* Search, the agent is at its start before any constraint applies.
+*/
+bool LPAStarSearch::blocked(Position* pos)
+{
+	if (!world->check_coord(pos->get_coord()))
+		return true;
+	return pos->get_depth() > 0 &&
+		constraints->find(HashStruct::hash_pos(pos)) != constraints->end();
+}
+
+/*
+* Check if a position can be on the solution path
+* @param pos: The position
+* @return true if it was reached at its depth and is consistent
+*/
+bool LPAStarSearch::on_path(Position* pos)
+{
+	auto found = states.find(HashStruct::hash_pos(pos));
+	return found != states.end() && found->second.g == pos->get_depth() &&
+		found->second.rhs == found->second.g;
+}
+
+/*
+* Get the cost of a position
+* @param pos: The position
+* @return its cost, INFINITE_COST if it was not reached
+*/
+unsigned short LPAStarSearch::get_g(Position* pos)
+{
+	auto found = states.find(HashStruct::hash_pos(pos));
+	if (found == states.end())
+		return INFINITE_COST;
+	return found->second.g;
+}
+
+/*
+* Recompute the rhs of a position from its predecessors and queue it if it is
+* inconsistent. Every step costs one, so a reached state costs its depth.
+* @param pos: The position to update
+*/
+void LPAStarSearch::update_vertex(Position* pos)
+{
+	unsigned short rhs = INFINITE_COST;
+	if (blocked(pos))
+		rhs = INFINITE_COST;
+	else if (pos->get_depth() == 0)
+		rhs = *pos->get_coord() == *start ? 0 : INFINITE_COST;
+	else
+	{
+		std::vector<Position> predecessors = std::vector<Position>();
+		get_neighbours(pos, -1, &predecessors);
+		for (unsigned int i = 0; i < predecessors.size() && rhs == INFINITE_COST; i++)
+		{
+			if (get_g(&predecessors[i]) != INFINITE_COST)
+				rhs = pos->get_depth();
+		}
+	}
+
+	unsigned int hash = HashStruct::hash_pos(pos);
+	auto found = states.find(hash);
+	LPAState* state;
+	if (found != states.end())
+		state = &found->second;
+	else
+	{
+		/* A state nothing reaches is not kept */
+		if (rhs == INFINITE_COST)
+			return;
+
+		LPAState add_state;
+		add_state.x = pos->get_x_coord();
+		add_state.y = pos->get_y_coord();
+		add_state.depth = pos->get_depth();
+		add_state.g = INFINITE_COST;
+		add_state.queued = false;
+		state = &states.emplace(hash, add_state).first->second;
+		count_state();
+		if (*pos->get_coord() == *goal)
+			goal_states.push_back(hash);
+	}
+
+	state->rhs = rhs;
+	state->queued = false;
+	if (state->g != state->rhs)
+		queue_state(state, false);
+}
+
+/*
+* Recompute the rhs of the sink, the earliest reached goal state, and queue
+* the sink if it is inconsistent
+*/
+void LPAStarSearch::update_sink()
+{
+	sink.rhs = INFINITE_COST;
+	for (unsigned int i = 0; i < goal_states.size(); i++)
+	{
+		unsigned short g = states.find(goal_states[i])->second.g;
+		if (g < sink.rhs)
+			sink.rhs = g;
+	}
+
+	sink.queued = false;
+	if (sink.g != sink.rhs)
+		queue_state(&sink, true);
+}
+
+/*
+* Queue the inconsistent states again with their current keys. The outdated
+* entries of the copied search are not copied with it.
+*/
+void LPAStarSearch::rebuild_queue()
+{
+	std::vector<LPAEntry> entries = std::vector<LPAEntry>();
+	for (auto it = states.begin(); it != states.end(); it++)
+	{
+		if (!it->second.queued)
+			continue;
+
+		LPAEntry entry;
+		entry.key_1 = it->second.key_1;
+		entry.key_2 = it->second.key_2;
+		entry.x = it->second.x;
+		entry.y = it->second.y;
+		entry.depth = it->second.depth;
+		entry.sink = false;
+		entries.push_back(entry);
+	}
+	if (sink.queued)
+	{
+		LPAEntry entry;
+		entry.key_1 = sink.key_1;
+		entry.key_2 = sink.key_2;
+		entry.x = 0;
+		entry.y = 0;
+		entry.depth = 0;
+		entry.sink = true;
+		entries.push_back(entry);
+	}
+	queue = std::priority_queue<LPAEntry, std::vector<LPAEntry>, LPAEntryGreater>(
+		LPAEntryGreater(), std::move(entries)
+		);
+}
+
+/*
+* Queue an inconsistent state with its current key
+* @param state: The state to queue
+* @param is_sink: True if the state is the sink
+*/
+void LPAStarSearch::queue_state(LPAState* state, bool is_sink)
+{
+	unsigned short cost = state->g < state->rhs ? state->g : state->rhs;
+
+	LPAEntry entry;
+	entry.key_2 = cost;
+	entry.key_1 = cost;
+	if (!is_sink)
+	{
+		/*
+		* The key saturates rather than wrapping around past the deepest position. Unlike
+		* the Euclidean distance of the A* Search the heuristic never overestimates a
+		* diagonal move, LPA* needs it consistent for the states it leaves inconsistent
+		* to be off the solution path.
+		*/
+		Coord coord = Coord(state->x, state->y);
+		unsigned int key = cost + coord.moves_to(goal);
+		entry.key_1 = key < INFINITE_COST ? key : INFINITE_COST;
+		entry.x = state->x;
+		entry.y = state->y;
+		entry.depth = state->depth;
+	}
+	else
+	{
+		entry.x = 0;
+		entry.y = 0;
+		entry.depth = 0;
+	}
+	entry.sink = is_sink;
+
+	state->key_1 = entry.key_1;
+	state->key_2 = entry.key_2;
+	state->queued = true;
+	queue.push(entry);
+}
+
+/*
+* Compare the key of the top of the queue with the key of the sink. A goal state
+* has the same key as the sink, it is expanded first so a constrained goal state
+* does not stay the earliest arrival.
+* @return true if the top of the queue has a key no larger than the sink's
+*/
+bool LPAStarSearch::top_before_sink()
+{
+	unsigned short sink_cost = sink.g < sink.rhs ? sink.g : sink.rhs;
+	const LPAEntry& top = queue.top();
+	if (top.key_1 != sink_cost)
+		return top.key_1 < sink_cost;
+	return top.key_2 <= sink_cost;
+}
+
+/*
+* Orders the queue by key, ties broken like A* Nodes
+* @return true if the first entry comes after the second one
+*/
+bool LPAStarSearch::LPAEntryGreater::operator()(const LPAEntry& entry_1, const LPAEntry& entry_2) const
+{
+	if (entry_1.key_1 != entry_2.key_1)
+		return entry_1.key_1 > entry_2.key_1;
+	if (entry_1.key_2 != entry_2.key_2)
+		return entry_1.key_2 > entry_2.key_2;
+	if (entry_1.x != entry_2.x)
+		return entry_1.x > entry_2.x;
+	if (entry_1.y != entry_2.y)
+		return entry_1.y > entry_2.y;
+	return entry_1.depth > entry_2.depth;
+}
+
+/*
+* Count a new state and update the high-water mark
+*/
+void LPAStarSearch::count_state()
+{
+	live_count++;
+	if (live_count > peak_count)
+		peak_count = live_count;
+}
+
+/*
+* Destructor
+*/
+LPAStarSearch::~LPAStarSearch()
+{
+	live_count -= states.size();
+}
@@ -0,0 +1,138 @@
+#ifndef LPASTARSEARCH_H
+#define LPASTARSEARCH_H
+
+#include <queue>
+#include <vector>
+#include <stack>
+#include <unordered_map>
+
+#include "Coordinates.h"
+#include "SearchStatus.h"
+
+class Agent;
+class World;
+class CancelToken;
+
+/*
+* Lifelong Planning A* over the time-expanded graph of an agent. Every reached
+* state keeps its cost g and the one step lookahead rhs computed from its
+* predecessors. When a child agent adds a constraint, it copies the search of
+* its parent and only the states made inconsistent by the constraint are
+* searched again, instead of removing descendants (FDR) or starting over.
+*
+* States of the goal cell have no successors, agents vanish at their goal.
+* They lead to a sink whose rhs is the earliest arrival, the search stops once
+* the sink is consistent and no queued key is smaller than the sink's. States
+* are never collapsed past the latest constraint, COLLAPSE_STATES only applies
+* to the A* Search.
+*/
+class LPAStarSearch
+{
+public:
+	/* Start a search from the start of an agent */
+	LPAStarSearch(Agent* search);
+	/* Copy the search of a pre-existing agent for one of its children */
+	LPAStarSearch(LPAStarSearch* copy, Agent* search);
+
+	/* Block a newly constrained position and queue the states it makes inconsistent */
+	void add_constraint(Position* constraint);
+	/* Search until the earliest arrival at the goal is consistent */
+	SearchStatus compute_shortest_path();
+	/* Get the solution path, the start at the top of the stack */
+	std::stack<Coord> get_path();
+
+	/* True if a reachable state lies at the depth bound, a deeper solution may exist */
+	bool get_reached_bound();
+
+	/* Number of states kept by every search and the most kept at once */
+	static unsigned long get_live_count() { return live_count; };
+	static unsigned long get_peak_count() { return peak_count; };
+	/* Restart the high-water mark from the number of states currently kept */
+	static void reset_peak_count() { peak_count = live_count; };
+
+	/* Destructor */
+	~LPAStarSearch();
+private:
+	/* Cost and lookahead of a reached state */
+	struct LPAState
+	{
+		/* Position of the state, kept as plain fields so states copy freely */
+		unsigned short x;
+		unsigned short y;
+		unsigned short depth;
+		/* Cost of the state, INFINITE_COST if it is unreachable */
+		unsigned short g;
+		/* Cost from the best predecessor */
+		unsigned short rhs;
+		/* True if the state is inconsistent and queued with the key below */
+		bool queued;
+		unsigned short key_1;
+		unsigned short key_2;
+	};
+
+	/* A queued state, outdated once its state is dequeued or queued with another key */
+	struct LPAEntry
+	{
+		unsigned short key_1;
+		unsigned short key_2;
+		unsigned short x;
+		unsigned short y;
+		unsigned short depth;
+		/* True for the sink, which has no position */
+		bool sink;
+	};
+
+	/* Orders the queue by key, ties broken like A* Nodes */
+	struct LPAEntryGreater
+	{
+		bool operator()(const LPAEntry& entry_1, const LPAEntry& entry_2) const;
+	};
+
+	/* World and goal of the agent */
+	World* world;
+	Coord* goal;
+	/* Start coordinate of the agent */
+	Coord* start;
+	/* Depth bound of the agent, states this deep have no successors */
+	unsigned short depth_bound;
+	/* Constraints of the agent */
+	std::unordered_map<unsigned int, Position>* constraints;
+	/* Deadline and cancellation flag of the agent's CBS Tree, NULL if there is none */
+	CancelToken* cancel_token;
+
+	/* Every reached state, keyed by the hash of its position */
+	std::unordered_map<unsigned int, LPAState> states;
+	/* Hashes of the reached states of the goal cell */
+	std::vector<unsigned int> goal_states;
+	/* Earliest arrival at the goal */
+	LPAState sink;
+	/* Inconsistent states */
+	std::priority_queue<LPAEntry, std::vector<LPAEntry>, LPAEntryGreater> queue;
+
+	/* Search the successors of a position, or its predecessors if depth_change is -1 */
+	void get_neighbours(Position* pos, int depth_change, std::vector<Position>* neighbours);
+	/* Check if a position cannot be occupied */
+	bool blocked(Position* pos);
+	/* Check if a position was reached at its depth and is consistent */
+	bool on_path(Position* pos);
+	/* Get the cost of a position, INFINITE_COST if it was not reached */
+	unsigned short get_g(Position* pos);
+	/* Recompute the rhs of a position and queue it if it is inconsistent */
+	void update_vertex(Position* pos);
+	/* Recompute the rhs of the sink from the goal states and queue it if it is inconsistent */
+	void update_sink();
+	/* Queue the inconsistent states again, dropping outdated entries */
+	void rebuild_queue();
+	/* Queue an inconsistent state with its current key */
+	void queue_state(LPAState* state, bool is_sink);
+	/* Compare the key of the top of the queue with the key of the sink */
+	bool top_before_sink();
+
+	/* Live and peak state counts across every search */
+	static unsigned long live_count;
+	static unsigned long peak_count;
+	/* Count a new state and update the high-water mark */
+	static void count_state();
+};
+
+#endif
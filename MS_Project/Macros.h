@@ -1,6 +1,13 @@
 #ifndef MACROS_H
 #define MACROS_H
 
+/*
+* NUM_TESTS, TEST_RUN_COUNT, TIME_LIMIT, CBS_CLASSIC, ADAPTIVE_REPAIR, LPA_STAR_REPAIR,
+* REMOVAL_THREADS, COLLAPSE_STATES, DISJOINT_SPLITTING, CORRIDOR_REASONING, TARGET_REASONING, MEMORY_BUDGET, PATH_CACHE_SIZE, ECBS_WEIGHT, ANYTIME_LNS,
+* PRIORITIZED_PLANNING, WARM_START and SEARCH_DEPTH only set the defaults of SolverOptions, which the command line of
+* main overrides. The other macros are fixed when compiling.
+*/
+
 /* Uncomment if you wish to run the regular search program (no test or world/agent generation) */
 //#define RUN_PROGRAM 1
 
@@ -23,6 +30,12 @@
 /* Uncomment if test should stop after a set period of time (value in seconds) */
 #define TIME_LIMIT 60
 
+/*
+* Number of expansions between reads of the clock when a search checks its
+* deadline, the cancellation flag is read on every expansion
+*/
+#define CANCEL_CHECK_INTERVAL 256
+
 /* Uncomment if the size of the CLOSED and OPEN list should be displayed when they are copied */
 //#define DISPLAY_LIST_SIZES 1
 
@@ -52,6 +65,103 @@
 /* Uncomment if the search should not use PCA* and use the classic CBS algorithm */
 //#define CBS_CLASSIC 1
 
+/*
+* Uncomment to decide for each child agent whether repairing the copied lists with PCA*
+* or searching again from the start is cheaper. Ignored if CBS_CLASSIC is defined.
+*/
+//#define ADAPTIVE_REPAIR 1
+
+/*
+* Uncomment to repair an incremental LPA* search of each child agent instead of its
+* A* lists. Ignored if CBS_CLASSIC or ADAPTIVE_REPAIR is defined.
+*/
+//#define LPA_STAR_REPAIR 1
+
+/* Uncomment to print the estimates behind each adaptive repair decision */
+//#define REPAIR_DECISION_DATA 1
+
+/*
+* Uncomment to remove the descendants of a new constraint with the PCA* search
+* instead of following the children bitmaps of the copied nodes
+*/
+//#define PCA_STAR_REMOVAL 1
+
+/*
+* Uncomment to remove the descendants of a new constraint with several threads,
+* one depth layer at a time. Ignored if PCA_STAR_REMOVAL is defined.
+*/
+//#define REMOVAL_THREADS 4
+
+/*
+* Comment out to keep every (coordinate, depth) state in the A* searches. When defined,
+* states past the latest constraint of an agent are duplicates of earlier states of
+* the same cell, so beyond its constraints an agent searches the plain grid.
+*/
+#define COLLAPSE_STATES 1
+
+/*
+* Uncomment to split CBSNodes on vertex conflicts into children that share no
+* solution: one forbids the position to an agent, the other makes the agent occupy
+* it (a landmark) and forbids it to the other agent. Needs the A* Search, so it is
+* ignored with SIPP_SEARCH and rejected with LPA_STAR_REPAIR, as --disjoint is with
+* either. Only the cbs solver splits disjointly, it is ignored with the others.
+*/
+//#define DISJOINT_SPLITTING 1
+
+/*
+* Uncomment to resolve a conflict of two agents crossing a 1 wide corridor in opposite
+* directions with one range of constraints per agent, keeping it from the corridor's
+* exit until the other agent could have crossed, instead of one depth at a time.
+* Only the cbs solver reasons about corridors, it is ignored with the others.
+*/
+//#define CORRIDOR_REASONING 1
+
+/*
+* Uncomment to keep agents at their goals once they finish instead of leaving the world.
+* Other agents then conflict with a finished agent at its goal (a target conflict), and a
+* constraint on an agent's own goal becomes a length constraint: the agent may not finish
+* until after it. Only applies to CBS, and needs the A* Search like DISJOINT_SPLITTING.
+*/
+//#define TARGET_REASONING 1
+
+/*
+* Uncomment if agents should search over (coordinate, safe interval) states
+* derived from their constraints (SIPP) rather than (coordinate, depth) states
+*/
+//#define SIPP_SEARCH 1
+
+/*
+* Uncomment to limit the number of A* Nodes kept in memory by a CBSTree.
+* When the limit is exceeded the OPEN and CLOSED lists of agents on the open
+* CBSNodes are released, and rebuilt by a new A* search when they branch again.
+*/
+//#define MEMORY_BUDGET 20000000
+
+/*
+* Number of low level results (an agent's path under a constraint set) a CBSTree
+* keeps for reuse by other CBSNodes, 0 to disable the cache
+*/
+#define PATH_CACHE_SIZE 4096
+
+/*
+* Uncomment to find bounded suboptimal solutions with ECBS instead of optimal
+* solutions with CBS. The value is the suboptimality factor (at least 1).
+*/
+//#define ECBS_WEIGHT 1.5
+
+/*
+* Uncomment to find a plan quickly by prioritized planning and improve it by
+* re-solving small groups of agents with CBS, returning the best plan found
+* when the time limit is reached instead of failing.
+*/
+//#define ANYTIME_LNS 1
+
+/* Uncomment to plan agents one at a time (fast, but neither optimal nor complete) */
+//#define PRIORITIZED_PLANNING 1
+
+/* Uncomment to bound CBS by the cost of a prioritized plan, pruning costlier nodes */
+//#define WARM_START 1
+
 /* Set the deth search limit */
 #define SEARCH_DEPTH 30000
 
@@ -0,0 +1,94 @@
+#include "PathCache.h"
+#include "HashStruct.h"
+
+/*
+* Constructor
+* @param p_agent_num: Index of the agent in the CBSNodes
+* @param p_constraint_hash: Hash of the agent's constraint set
+* @param p_path: The solution path, NULL if the agent has no solution
+*/
+CachedPath::CachedPath(int p_agent_num, unsigned long long p_constraint_hash, std::stack<Coord>* p_path)
+{
+	agent_num = p_agent_num;
+	constraint_hash = p_constraint_hash;
+
+	/* Store the path if there is one */
+	feasible = (p_path != NULL);
+	if (feasible)
+		path = std::stack<Coord>(*p_path);
+}
+
+/*
+* Constructor
+* @param p_capacity: The maximum number of results stored
+*/
+PathCache::PathCache(unsigned int p_capacity)
+{
+	capacity = p_capacity;
+	entries = std::list<CachedPath>();
+	index = std::unordered_map<unsigned long long, std::list<CachedPath>::iterator>();
+	hits = 0;
+	misses = 0;
+}
+
+/*
+* Find a cached result and mark it as the most recently used
+* @param agent_num: Index of the agent in the CBSNodes
+* @param constraint_hash: Hash of the agent's constraint set
+* @return the cached result, NULL if there is none
+*/
+CachedPath* PathCache::find(int agent_num, unsigned long long constraint_hash)
+{
+	auto it = index.find(HashStruct::hash_agent_constraints(agent_num, constraint_hash));
+
+	/* Make sure the result found is for the same agent and constraint set */
+	if (
+		it == index.end() ||
+		it->second->get_agent_num() != agent_num ||
+		it->second->get_constraint_hash() != constraint_hash
+		)
+	{
+		misses++;
+		return NULL;
+	}
+
+	/* Move the result to the front of the list */
+	entries.splice(entries.begin(), entries, it->second);
+	hits++;
+	return &entries.front();
+}
+
+/*
+* Store a result, evicting the least recently used one if the cache is full
+* @param agent_num: Index of the agent in the CBSNodes
+* @param constraint_hash: Hash of the agent's constraint set
+* @param path: The solution path, NULL if the agent has no solution
+*/
+void PathCache::insert(int agent_num, unsigned long long constraint_hash, std::stack<Coord>* path)
+{
+	/* A cache with no capacity stores nothing */
+	if (capacity == 0)
+		return;
+
+	unsigned long long key = HashStruct::hash_agent_constraints(agent_num, constraint_hash);
+
+	/* Replace a prior result with the same key */
+	auto it = index.find(key);
+	if (it != index.end())
+	{
+		entries.erase(it->second);
+		index.erase(it);
+	}
+
+	/* Make room by removing the least recently used result */
+	if (entries.size() >= capacity)
+	{
+		index.erase(HashStruct::hash_agent_constraints(
+			entries.back().get_agent_num(), entries.back().get_constraint_hash()
+			));
+		entries.pop_back();
+	}
+
+	entries.emplace_front(agent_num, constraint_hash, path);
+	index[key] = entries.begin();
+}
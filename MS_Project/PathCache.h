@@ -0,0 +1,68 @@
+#ifndef PATHCACHE_H
+#define PATHCACHE_H
+
+#include <list>
+#include <stack>
+#include <unordered_map>
+
+#include "Coordinates.h"
+
+/*
+* The result of a low level search: the path found for one agent under one
+* set of constraints, or the fact that no path exists
+*/
+class CachedPath
+{
+public:
+	/* Constructor, a NULL path means the search ran out of nodes */
+	CachedPath(int p_agent_num, unsigned long long p_constraint_hash, std::stack<Coord>* p_path);
+
+	/* Accessors */
+	int get_agent_num() const { return agent_num; };
+	unsigned long long get_constraint_hash() const { return constraint_hash; };
+	bool is_feasible() const { return feasible; };
+	std::stack<Coord>* get_path() { return &path; };
+private:
+	/* Index of the agent in the CBSNodes */
+	int agent_num;
+	/* Hash of the agent's constraint set */
+	unsigned long long constraint_hash;
+	/* False if the agent has no solution under the constraints */
+	bool feasible;
+	/* Solution path of the agent */
+	std::stack<Coord> path;
+};
+
+/*
+* Bounded least recently used cache of low level search results, keyed by
+* agent and constraint set. Shared by every CBSNode of a CBSTree so siblings
+* and cousins re-planning an agent under equal constraints reuse the result.
+*/
+class PathCache
+{
+public:
+	/* Constructor */
+	PathCache(unsigned int p_capacity);
+
+	/* Find a cached result, NULL if there is none */
+	CachedPath* find(int agent_num, unsigned long long constraint_hash);
+	/* Store a result, evicting the least recently used one if the cache is full */
+	void insert(int agent_num, unsigned long long constraint_hash, std::stack<Coord>* path);
+
+	/* Accessors */
+	unsigned int size() const { return entries.size(); };
+	int get_hits() const { return hits; };
+	int get_misses() const { return misses; };
+private:
+	/* Maximum number of results stored */
+	unsigned int capacity;
+	/* Results, most recently used first */
+	std::list<CachedPath> entries;
+	/* Position of each result in entries, keyed by agent and constraint set */
+	std::unordered_map<unsigned long long, std::list<CachedPath>::iterator> index;
+	/* Lookup counters */
+	int hits;
+	int misses;
+};
+
+#endif
@@ -10,7 +10,9 @@
 #include "AStarNodeMultiMap.h"
 #include "Macros.h"
 #include "Exceptions.h"
+#include "CancelToken.h"
 #include "HashStruct.h"
+#include "PathClearWorkspace.h"
 
 #ifdef PCA_STAR_SIZE
 #include <iostream>
@@ -32,18 +34,16 @@ PathClearAStar::PathClearAStar(Agent* search, Position* start_pos)
 	/* Goal coordinate of the agent */
 	goal = search->get_goal();
 
-	/* OPEN list in the form of a min heap */
-	open_list = std::priority_queue<AStarNode*, std::vector<AStarNode*>, std::greater<AStarNode> >();
-
-	/* OPEN list in the form of a hash table */
-	open_list_hash_table = new AStarNodeList();
+	/* Reuse the OPEN and CLOSED lists of an earlier search of this thread */
+	workspace = PathClearWorkspace::acquire();
+	open_list = &workspace->open_list;
+	open_list_hash_table = workspace->open_list_hash_table;
+	closed_list = workspace->closed_list;
 
 	/* Place the root on the OPEN list */
 	AStarNode* root = new AStarNode(start_pos, NULL, calc_cost(start_pos));
-	open_list.emplace(root);
-
-	/* CLOSED list for the search in the form of a hash table */
-	closed_list = new AStarNodeList();
+	open_list->emplace(root);
+	open_list_hash_table->add_node(root);
 
 	/*
 	* Hash table for the conflicts at this node. The key is the cantor pair of the Position
@@ -59,39 +59,49 @@ PathClearAStar::PathClearAStar(Agent* search, Position* start_pos)
 	parent_closed_list = search->get_closed_list();
 
 	/* Remove the constraint from both the OPEN and CLOSED list of the parent A* search */
+	AStarNode* open_node = parent_open_list->check_duplicate(start_pos);
+	AStarNode* closed_node = parent_closed_list->check_duplicate(start_pos);
 	parent_open_list->remove_hash(start_pos);
 	parent_closed_list->remove_hash(start_pos);
 
 	/*
-	* If the constraint is the goal node, then it will be at the top of the OPEN list.
-	* Remove it.
+	* No list holds the CLOSED node anymore. An OPEN node (the goal node if the
+	* constraint is on the goal) is still on the heap, which deletes it once popped.
 	*/
-	if (*start_pos->get_coord() == *goal)
-	{
-		std::priority_queue<AStarNode*, std::vector<AStarNode*>, std::greater<AStarNode> >*
-			parent_open_heap = search->get_open_list();
-		if (!(*parent_open_heap->top()->get_pos() == *start_pos))
-			throw TerminalException("Top of heap should be goal but was not.");
-		parent_open_heap->pop();
-	}
+	delete closed_node;
+	if (open_node != NULL)
+		open_node->mark_for_deletion();
 
 	/* Get the name of the agent */
 	name = search->get_name();
+
+	/* States at least this deep may be missing from the lists of the parent A* Search */
+	collapse_depth = search->get_collapse_depth();
+	depth_bound = search->get_depth_bound();
+
+	status = SEARCH_RUNNING;
+	cancel_token = search->get_cancel_token();
 }
 
 /* 
 * Clear the OPEN and CLOSED lists of descendants of start_pos 
 * @return true if the goal node is removed, false if it is not
-* (a path still exists to the goal node)
+* (a path still exists to the goal node or the time limit was reached)
 */
 #include <iostream>
 bool PathClearAStar::path_clear_a_star()
 {
-	while (!open_list.empty())
+	while (!open_list->empty())
 	{
+		/* The parent lists are only partly cleared, the caller must not search them */
+		if (cancel_token != NULL && cancel_token->poll())
+		{
+			status = SEARCH_TIMEOUT;
+			return false;
+		}
 		/* Get the minimum cost node in the list */
-		AStarNode* top = open_list.top();
-		open_list.pop();
+		AStarNode* top = open_list->top();
+		open_list->pop();
 
 
 
@@ -104,13 +114,22 @@ bool PathClearAStar::path_clear_a_star()
 		{
 #ifdef PCA_STAR_SIZE
 			/* Display the size of the OPEN and CLOSED lists */
-			std::cout << "PCA* OPEN LIST SIZE: " << open_list.size() << std::endl;
+			std::cout << "PCA* OPEN LIST SIZE: " << open_list->size() << std::endl;
 			std::cout << "PCA* CLOSED LIST SIZE:" << closed_list->get_size() << std::endl;
 #endif
 			remove_extra_open_nodes();
+			status = SEARCH_SOLVED;
 			return true;
 		}
 
+		/* The A* search has no successors of nodes at its depth bound */
+		if (top->get_pos()->get_depth() >= depth_bound)
+		{
+			closed_list->add_node(top);
+			open_list_hash_table->remove_hash(top);
+			continue;
+		}
+
 		/* Generate successors */
 		std::vector<Position> successors;
 		get_successors(top->get_pos(), &successors);
@@ -130,7 +149,7 @@ bool PathClearAStar::path_clear_a_star()
 
 			/* Create a new node and add it to the OPEN list (both heap and hash table) */
 			AStarNode* add_node = new AStarNode(&successors[i], top, calc_cost(&successors[i]));
-			open_list.push(add_node);
+			open_list->push(add_node);
 			open_list_hash_table->add_node(add_node);
 		}
 		/* Add top to the CLOSED list unless a duplicate is found */
@@ -139,6 +158,7 @@ bool PathClearAStar::path_clear_a_star()
 		/* Remove the node from the OPEN list without deleting the node */
 		open_list_hash_table->remove_hash(top);
 	}
+	status = SEARCH_SOLVED;
 	return false;
 }
 
@@ -219,6 +239,10 @@ bool PathClearAStar::del_successors(Position* pos, Coord* parent)
 	/* Check the A* CLOSED list */
 	int closed_result = parent_closed_list->delete_node(pos, parent, true);
 
+	/* A state dropped as a duplicate by the A* search has no descendants to remove */
+	if (closed_result == 0 && pos->get_depth() >= collapse_depth)
+		return false;
+
 	/* If the node cannot be found in either A* list, throw an error */
 	if (closed_result == 0)
 	{
@@ -328,6 +352,6 @@ void PathClearAStar::dec_push_unexpanded(
 */
 PathClearAStar::~PathClearAStar()
 {
-	delete open_list_hash_table;
-	delete closed_list;
+	/* Give the lists back to the pool of this thread as soon as the search is done */
+	PathClearWorkspace::release(workspace);
 }
\ No newline at end of file
@@ -4,6 +4,10 @@
 #include <queue>
 #include <functional>
 #include <unordered_map>
+#include <string>
+
+#include "Macros.h"
+#include "SearchStatus.h"
 
 class Agent;
 class AStarNodeList;
@@ -11,6 +15,8 @@ class AStarNode;
 class Position;
 class World;
 class Coord;
+class CancelToken;
+class PathClearWorkspace;
 
 class PathClearAStar
 {
@@ -25,6 +31,9 @@ public:
 	/* Clear the OPEN and CLOSED lists of descendants of start_pos */
 	bool path_clear_a_star();
 
+	/* status accessor function */
+	SearchStatus get_status() const { return status; };
+
 	/* Destructor */
 	~PathClearAStar();
 private:
@@ -32,8 +41,10 @@ private:
 	World* world;
 	/* Goal coordinate of the agent */
 	Coord* goal;
+	/* Lists of the search, taken from the pool of the thread and given back by the destructor */
+	PathClearWorkspace* workspace;
 	/* OPEN list in the form of a min heap */
-	std::priority_queue<AStarNode*, std::vector<AStarNode*>, std::greater<AStarNode> > open_list;
+	std::priority_queue<AStarNode*, std::vector<AStarNode*>, std::greater<AStarNode> >* open_list;
 	/* OPEN list in the form of a hash table */
 	AStarNodeList* open_list_hash_table;
 	/* CLOSED list for the search in the form of a hash table */
@@ -50,6 +61,14 @@ private:
 	AStarNodeList* parent_closed_list;
 	/* The name of the PCA* search agent */
 	std::string name;
+	/* Shallowest depth of a state the parent A* Search dropped as a duplicate */
+	unsigned short collapse_depth;
+	/* Depth bound of the parent A* Search, it never expands nodes this deep */
+	unsigned short depth_bound;
+	/* Outcome of the search, a timed out search leaves the parent lists unusable */
+	SearchStatus status;
+	/* Deadline and cancellation flag of the agent's CBS Tree, NULL if there is none */
+	CancelToken* cancel_token;
 
 	/* Calculate the cost of a position */
 	double calc_cost(Position* pos);
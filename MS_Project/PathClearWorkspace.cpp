@@ -0,0 +1,82 @@
+#include "PathClearWorkspace.h"
+#include "AStarNode.h"
+#include "AStarNodeList.h"
+
+/* Workspaces a thread is not using, deleted when the thread exits */
+struct WorkspacePool
+{
+	std::vector<PathClearWorkspace*> workspaces;
+
+	~WorkspacePool()
+	{
+		for (unsigned int i = 0; i < workspaces.size(); i++)
+			delete workspaces[i];
+	}
+};
+
+/* Pool of the calling thread */
+static thread_local WorkspacePool pool;
+
+/*
+* Constructor
+*/
+PathClearWorkspace::PathClearWorkspace()
+{
+	open_list = std::priority_queue<AStarNode*, std::vector<AStarNode*>, std::greater<AStarNode> >();
+	open_list_hash_table = new AStarNodeList();
+	closed_list = new AStarNodeList();
+}
+
+/*
+* Take an empty workspace from the pool of the calling thread, creating one if
+* the pool is empty
+* @return the workspace, to be given back with release()
+*/
+PathClearWorkspace* PathClearWorkspace::acquire()
+{
+	if (pool.workspaces.empty())
+		return new PathClearWorkspace();
+
+	PathClearWorkspace* workspace = pool.workspaces.back();
+	pool.workspaces.pop_back();
+	return workspace;
+}
+
+/*
+* Empty a workspace and return it to the pool of the calling thread
+* @param workspace: A workspace taken with acquire()
+*/
+void PathClearWorkspace::release(PathClearWorkspace* workspace)
+{
+	workspace->clear();
+	pool.workspaces.push_back(workspace);
+}
+
+/*
+* Number of workspaces waiting in the pool of the calling thread
+* @return the pool size
+*/
+unsigned int PathClearWorkspace::get_pool_size()
+{
+	return pool.workspaces.size();
+}
+
+/*
+* Delete the nodes of the lists, keeping the hash tables for the next search
+*/
+void PathClearWorkspace::clear()
+{
+	/* Every node on the heap is also on the OPEN hash table */
+	open_list = std::priority_queue<AStarNode*, std::vector<AStarNode*>, std::greater<AStarNode> >();
+	open_list_hash_table->delete_nodes();
+	closed_list->delete_nodes();
+}
+
+/*
+* Destructor
+*/
+PathClearWorkspace::~PathClearWorkspace()
+{
+	delete open_list_hash_table;
+	delete closed_list;
+}
@@ -0,0 +1,42 @@
+#ifndef PATHCLEARWORKSPACE_H
+#define PATHCLEARWORKSPACE_H
+
+#include <queue>
+#include <functional>
+#include <vector>
+
+class AStarNode;
+class AStarNodeList;
+
+/*
+* The OPEN and CLOSED lists of a PCA* search. Each thread keeps a pool of them
+* so the searches of a thread reuse the same hash tables instead of allocating
+* new ones for every child agent. A workspace goes back to the pool, emptied,
+* as soon as its search finishes.
+*/
+class PathClearWorkspace
+{
+public:
+	/* Take an empty workspace from the pool of the calling thread */
+	static PathClearWorkspace* acquire();
+	/* Empty a workspace and return it to the pool of the calling thread */
+	static void release(PathClearWorkspace* workspace);
+	/* Number of workspaces waiting in the pool of the calling thread */
+	static unsigned int get_pool_size();
+
+	/* OPEN list in the form of a min heap */
+	std::priority_queue<AStarNode*, std::vector<AStarNode*>, std::greater<AStarNode> > open_list;
+	/* OPEN list in the form of a hash table, it owns the nodes of the heap */
+	AStarNodeList* open_list_hash_table;
+	/* CLOSED list for the search in the form of a hash table */
+	AStarNodeList* closed_list;
+
+	/* Constructor and destructor */
+	PathClearWorkspace();
+	~PathClearWorkspace();
+private:
+	/* Delete the nodes of the lists, keeping the hash tables for the next search */
+	void clear();
+};
+
+#endif
@@ -0,0 +1,125 @@
+#include <utility>
+#include <algorithm>
+
+#include "PrioritizedPlanner.h"
+#include "Agent.h"
+#include "World.h"
+#include "FocalSearch.h"
+
+/*
+* Constructor
+* @param p_agents: The agents to plan for
+*/
+PrioritizedPlanner::PrioritizedPlanner(std::vector<Agent*>* p_agents)
+{
+	agents = *p_agents;
+	paths = std::vector<std::stack<Coord> >(agents.size());
+	reserved = ReservationTable();
+	park_at_goal = false;
+	cost = 0;
+	planned = 0;
+	status = SEARCH_RUNNING;
+
+	/* Plan the agents in the order given */
+	order = std::vector<int>();
+	int num_agents = agents.size();
+	for (int i = 0; i < num_agents; i++)
+		order.push_back(i);
+}
+
+/*
+* Plan the agents in a given order
+* @param p_order: Every agent number once, highest priority first
+*/
+void PrioritizedPlanner::set_order(std::vector<int>* p_order)
+{
+	order = *p_order;
+}
+
+/*
+* Plan the agents in order of the number of moves between their start and
+* goal, ignoring obstacles. Ties keep the order the agents were given in.
+* @param longest_first: True if the farthest agents are planned first
+*/
+void PrioritizedPlanner::order_by_distance(bool longest_first)
+{
+	/* Distance of each agent */
+	int num_agents = agents.size();
+	std::vector<int> distance = std::vector<int>(num_agents);
+	for (int i = 0; i < num_agents; i++)
+		distance[i] = agents[i]->get_start()->moves_to(agents[i]->get_goal());
+
+	/* Sort by distance, then by the current order */
+	std::vector<std::pair<int, int> > keys = std::vector<std::pair<int, int> >();
+	for (int i = 0; i < num_agents; i++)
+	{
+		int key = longest_first ? -distance[order[i]] : distance[order[i]];
+		keys.push_back(std::make_pair(key, i));
+	}
+	std::sort(keys.begin(), keys.end());
+
+	std::vector<int> old_order = order;
+	for (int i = 0; i < num_agents; i++)
+		order[i] = old_order[keys[i].second];
+}
+
+/*
+* Plan every agent in priority order with an optimal space-time search that
+* never enters reserved space. The reservations of an earlier plan are dropped.
+* @return true if every agent has a path, false otherwise
+*/
+bool PrioritizedPlanner::plan()
+{
+	paths = std::vector<std::stack<Coord> >(agents.size());
+	reserved = ReservationTable();
+	cost = 0;
+	status = SEARCH_RUNNING;
+
+	int num_agents = order.size();
+	for (planned = 0; planned < num_agents; planned++)
+	{
+		if (!plan_agent(order[planned]))
+			return false;
+	}
+	status = SEARCH_SOLVED;
+	return true;
+}
+
+/*
+* Plan a single agent around the reservations and reserve its path. Once
+* every reservation has passed the world no longer changes, so an agent can
+* reach any reachable coordinate within one move per coordinate of the world.
+* Searching deeper than that is pointless.
+* @param agent_num: The number of the agent to plan
+* @return true if the agent has a path, false otherwise
+*/
+bool PrioritizedPlanner::plan_agent(int agent_num)
+{
+	Agent* agent = agents[agent_num];
+
+	FocalSearch search = FocalSearch(agent, 1, NULL);
+	search.set_reservations(&reserved);
+	search.set_max_depth(reserved.get_horizon() + 1 + agent->get_world()->get_size());
+
+	/* An agent staying at its goal must arrive after every other visit to it */
+	if (park_at_goal)
+		search.set_min_goal_depth(reserved.get_last_visit(agent->get_goal()) + 1);
+
+	/* Only a timeout stops planning for a reason other than the order */
+	if (!search.focal_search())
+	{
+		if (search.get_status() == SEARCH_TIMEOUT)
+			status = SEARCH_TIMEOUT;
+		else
+			status = SEARCH_PRIORITY_FAILED;
+		return false;
+	}
+
+	/* Reserve the path for the remaining agents */
+	paths[agent_num] = *search.get_path();
+	reserved.add_path(paths[agent_num], park_at_goal);
+
+	if (static_cast<int>(paths[agent_num].size()) - 1 > cost)
+		cost = paths[agent_num].size() - 1;
+	return true;
+}
@@ -0,0 +1,65 @@
+#ifndef PRIORITIZEDPLANNER_H
+#define PRIORITIZEDPLANNER_H
+
+#include <vector>
+#include <stack>
+
+#include "Coordinates.h"
+#include "ReservationTable.h"
+#include "SearchStatus.h"
+
+class Agent;
+
+/*
+* Fast, non-optimal planner that finds a path for one agent at a time. Each
+* agent's path reserves its vertices and edges, and later agents plan around
+* every reservation. Not complete: an agent may be left without a path.
+*/
+class PrioritizedPlanner
+{
+public:
+	/* Constructor, agents are planned in the order given unless the order is set */
+	PrioritizedPlanner(std::vector<Agent*>* p_agents);
+
+	/* Plan every agent, return false if an agent has no path around the reservations */
+	bool plan();
+
+	/* Plan the agents in a given order of agent numbers */
+	void set_order(std::vector<int>* p_order);
+	/* Plan the agents in order of the distance between their start and goal */
+	void order_by_distance(bool longest_first);
+	/* True if agents stay at their goal for good, false if they leave the world there */
+	void set_park_at_goal(bool p_park_at_goal) { park_at_goal = p_park_at_goal; };
+
+	/* Accessors */
+	/* Path of each agent, in the same order as the agents given */
+	std::vector<std::stack<Coord> >* get_paths() { return &paths; };
+	std::vector<int>* get_order() { return &order; };
+	/* Largest path cost of any agent */
+	int get_cost() const { return cost; };
+	/* Number of agents planned before the first that had no path */
+	int get_planned() const { return planned; };
+	SearchStatus get_status() const { return status; };
+private:
+	/* Outcome of the last plan, SEARCH_PRIORITY_FAILED if an agent has no path */
+	SearchStatus status;
+	/* Agents to plan for */
+	std::vector<Agent*> agents;
+	/* Agent numbers in the order they are planned */
+	std::vector<int> order;
+	/* True if agents stay at their goal for good */
+	bool park_at_goal;
+	/* Path of each agent, in the same order as agents */
+	std::vector<std::stack<Coord> > paths;
+	/* Space reserved by the agents planned so far */
+	ReservationTable reserved;
+	/* Largest path cost of any agent */
+	int cost;
+	/* Number of agents planned */
+	int planned;
+
+	/* Plan a single agent around the reservations */
+	bool plan_agent(int agent_num);
+};
+
+#endif
@@ -0,0 +1,54 @@
+#include "PrioritizedTree.h"
+#include "PrioritizedPlanner.h"
+#include "CBSNode.h"
+
+/*
+* Constructor based on files describing the world and agents. No CBS root is
+* created, so no agent is searched before the planner runs.
+* @param agent_file: The name of the file containing each agent
+* @param world_file: The name of the file containing the world
+* @param p_options: Configuration of the search, NULL for the defaults of Macros.h
+*/
+PrioritizedTree::PrioritizedTree(
+	std::string agent_file, std::string world_file, const SolverOptions* p_options
+	)
+	: CBSTree(agent_file, world_file, p_options, false)
+{
+	planner = new PrioritizedPlanner(&agents);
+}
+
+/*
+* Plan every agent in priority order. An agent left without a path is moved
+* to the front of the order and planning starts over, at most once per agent.
+* @return a CBSNode holding the plan, NULL if no order tried planned every agent
+*/
+CBSNode* PrioritizedTree::search_tree()
+{
+	int num_agents = agents.size();
+	for (int attempt = 0; attempt <= num_agents; attempt++)
+	{
+		if (planner->plan())
+			return plan_node(planner->get_paths());
+
+		/* An agent with no path when planned first has none in any order */
+		int failed = planner->get_planned();
+		if (planner->get_status() != SEARCH_PRIORITY_FAILED || failed == 0)
+			break;
+
+		std::vector<int> order = *planner->get_order();
+		int agent_num = order[failed];
+		order.erase(order.begin() + failed);
+		order.insert(order.begin(), agent_num);
+		planner->set_order(&order);
+	}
+	status = planner->get_status();
+	return NULL;
+}
+
+/*
+* Destructor
+*/
+PrioritizedTree::~PrioritizedTree()
+{
+	delete planner;
+}
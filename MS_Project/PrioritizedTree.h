@@ -0,0 +1,35 @@
+#ifndef PRIORITIZEDTREE_H
+#define PRIORITIZEDTREE_H
+
+#include <string>
+#include <vector>
+
+#include "CBSTree.h"
+
+class PrioritizedPlanner;
+
+/*
+* Standalone prioritized planning solver using the same files and solution
+* interface as a CBSTree. Fast but neither optimal nor complete.
+*/
+class PrioritizedTree : public CBSTree
+{
+public:
+	/* Constructor */
+	PrioritizedTree(
+		std::string agent_file, std::string world_file, const SolverOptions* p_options = NULL
+		);
+	/* The planner, to configure the priority order and goal occupancy before solving */
+	PrioritizedPlanner* get_planner() { return planner; };
+
+	/* Destructor */
+	virtual ~PrioritizedTree();
+private:
+	/* Planner for the agents of the tree */
+	PrioritizedPlanner* planner;
+
+	/* Plan every agent in priority order, return the plan */
+	virtual CBSNode* search_tree();
+};
+
+#endif
@@ -0,0 +1,203 @@
+#include "ReservationTable.h"
+#include "Coordinates.h"
+#include "HashStruct.h"
+
+/*
+* Constructor creates an empty table
+*/
+ReservationTable::ReservationTable()
+{
+	vertices = std::unordered_map<unsigned long long, int>();
+	edges = std::unordered_map<unsigned long long, int>();
+	last_visits = std::unordered_map<unsigned int, int>();
+	parked = std::unordered_map<unsigned int, int>();
+	horizon = -1;
+}
+
+/*
+* Reserve every vertex and edge of a path
+* @param path: The path to reserve, with the start coordinate (depth 0) on top
+* @param park_at_goal: True if the agent stays at its goal after the path ends,
+* false if it leaves the world
+*/
+void ReservationTable::add_path(std::stack<Coord> path, bool park_at_goal)
+{
+	/* Previous coordinate in the path */
+	Coord prev_coord = path.top();
+	path.pop();
+
+	/* Depth of the current coordinate */
+	unsigned short depth = 0;
+	vertices[vertex_key(&prev_coord, depth)]++;
+	visit(&prev_coord, depth);
+
+	while (!path.empty())
+	{
+		Coord curr_coord = path.top();
+		path.pop();
+		depth++;
+
+		/* Reserve the position and the move into it */
+		vertices[vertex_key(&curr_coord, depth)]++;
+		edges[edge_key(&prev_coord, &curr_coord, depth)]++;
+		visit(&curr_coord, depth);
+
+		prev_coord = curr_coord;
+	}
+
+	/* Keep the goal coordinate after the path ends */
+	if (park_at_goal)
+	{
+		auto it = parked.find(HashStruct::coord_key(&prev_coord));
+		if (it == parked.end() || it->second > depth)
+			parked[HashStruct::coord_key(&prev_coord)] = depth;
+	}
+
+	if (depth > horizon)
+		horizon = depth;
+}
+
+/*
+* Last depth at which a coordinate is visited by a path in the table
+* @param coord: The coordinate to check
+* @return the last depth of a visit, -1 if no path visits the coordinate
+*/
+int ReservationTable::get_last_visit(Coord* coord)
+{
+	auto it = last_visits.find(HashStruct::coord_key(coord));
+	if (it == last_visits.end())
+		return -1;
+	return it->second;
+}
+
+/*
+* Record a visit to a coordinate
+* @param coord: The coordinate visited
+* @param depth: The depth of the visit
+*/
+void ReservationTable::visit(Coord* coord, unsigned short depth)
+{
+	int& last_visit = last_visits.emplace(HashStruct::coord_key(coord), -1).first->second;
+	if (depth > last_visit)
+		last_visit = depth;
+}
+
+/*
+* Number of paths occupying a position
+* @param pos: The position to check
+* @return the number of paths in the table at pos
+*/
+int ReservationTable::count_vertex(Position* pos)
+{
+	int count = 0;
+	auto it = vertices.find(vertex_key(pos->get_coord(), pos->get_depth()));
+	if (it != vertices.end())
+		count = it->second;
+
+	/* Agents parked at their goal occupy it from the end of their path on */
+	if (!parked.empty())
+	{
+		auto park_it = parked.find(HashStruct::coord_key(pos->get_coord()));
+		if (park_it != parked.end() && pos->get_depth() > park_it->second)
+			count++;
+	}
+	return count;
+}
+
+/*
+* Number of paths swapping places with a move from one coordinate to another
+* @param from: The coordinate moved from (at depth - 1)
+* @param to: The coordinate moved to (at depth)
+* @param depth: The depth at which the move ends
+* @return the number of paths moving from 'to' to 'from' at the same time
+*/
+int ReservationTable::count_swap(Coord* from, Coord* to, unsigned short depth)
+{
+	/* Waiting in place can not swap with another agent */
+	if (*from == *to)
+		return 0;
+
+	auto it = edges.find(edge_key(to, from, depth));
+	if (it == edges.end())
+		return 0;
+	return it->second;
+}
+
+/*
+* Number of conflicts created by moving from a coordinate into a position
+* @param from: The coordinate moved from (at to's depth - 1)
+* @param to: The position moved to
+* @return the number of vertex and swap conflicts of the move
+*/
+int ReservationTable::count_move(Coord* from, Position* to)
+{
+	return count_vertex(to) + count_swap(from, to->get_coord(), to->get_depth());
+}
+
+/*
+* Number of conflicts between a path and the paths in the table. The start
+* coordinate is not checked because starting coordinates are assumed unique.
+* @param path: The path to check, with the start coordinate on top
+* @return the number of vertex and swap conflicts along the path
+*/
+int ReservationTable::count_path_conflicts(std::stack<Coord> path)
+{
+	/* Total number of conflicts */
+	int conflicts = 0;
+
+	Coord prev_coord = path.top();
+	path.pop();
+	unsigned short depth = 0;
+
+	while (!path.empty())
+	{
+		Coord curr_coord = path.top();
+		path.pop();
+		depth++;
+
+		Position curr_pos = Position(curr_coord, depth);
+		conflicts += count_move(&prev_coord, &curr_pos);
+
+		prev_coord = curr_coord;
+	}
+	return conflicts;
+}
+
+/*
+* Remove every reservation
+*/
+void ReservationTable::clear()
+{
+	vertices.clear();
+	edges.clear();
+	last_visits.clear();
+	parked.clear();
+	horizon = -1;
+}
+
+/*
+* Pack a coordinate and depth into a single key
+* @param coord: The coordinate
+* @param depth: The depth
+* @return a key unique to the coordinate and depth
+*/
+unsigned long long ReservationTable::vertex_key(Coord* coord, unsigned short depth)
+{
+	unsigned long long key = coord->get_xcoord();
+	key = (key << 16) | coord->get_ycoord();
+	return (key << 16) | depth;
+}
+
+/*
+* Pack a move into a single key. The move is stored as the start coordinate
+* and the direction of the move, which is the parent bitmap hash of the start.
+* @param from: The coordinate moved from
+* @param to: The coordinate moved to
+* @param depth: The depth at which the move ends
+* @return a key unique to the move
+*/
+unsigned long long ReservationTable::edge_key(Coord* from, Coord* to, unsigned short depth)
+{
+	unsigned long long key = vertex_key(from, depth);
+	return (key << 9) | HashStruct::hash_coord_comp(from, to);
+}
@@ -0,0 +1,61 @@
+#ifndef RESERVATIONTABLE_H
+#define RESERVATIONTABLE_H
+
+#include <unordered_map>
+#include <stack>
+
+class Coord;
+class Position;
+
+/*
+* Space-time table of the vertices and edges used by a set of agent paths.
+* Each entry counts the paths using it so the table can be used both to
+* count conflicts with other agents and to forbid moves into reserved space.
+*/
+class ReservationTable
+{
+public:
+	/* Constructor */
+	ReservationTable();
+
+	/*
+	* Reserve every vertex and edge of a path (the start coordinate is at depth 0).
+	* A parked path also keeps its goal coordinate from its last depth on.
+	*/
+	void add_path(std::stack<Coord> path, bool park_at_goal = false);
+	/* Number of paths occupying a position */
+	int count_vertex(Position* pos);
+	/* Number of paths moving between two coordinates in the opposite direction at a depth */
+	int count_swap(Coord* from, Coord* to, unsigned short depth);
+	/* Number of conflicts created by moving from a coordinate into a position */
+	int count_move(Coord* from, Position* to);
+	/* Number of conflicts between a path and the paths in the table */
+	int count_path_conflicts(std::stack<Coord> path);
+	/* Remove every reservation */
+	void clear();
+
+	/* Last depth at which a coordinate is visited, -1 if it never is */
+	int get_last_visit(Coord* coord);
+
+	/* Deepest reserved position, -1 if nothing is reserved */
+	int get_horizon() const { return horizon; };
+private:
+	/* Paths occupying each position, keyed by the packed position */
+	std::unordered_map<unsigned long long, int> vertices;
+	/* Paths moving along each edge at each depth, keyed by the packed move */
+	std::unordered_map<unsigned long long, int> edges;
+	/* Last depth each coordinate is visited at, keyed by the packed coordinate */
+	std::unordered_map<unsigned int, int> last_visits;
+	/* Depth from which each parked goal coordinate is occupied for good */
+	std::unordered_map<unsigned int, int> parked;
+	/* Deepest reserved position */
+	int horizon;
+
+	/* Pack a position or a move into a single key */
+	static unsigned long long vertex_key(Coord* coord, unsigned short depth);
+	static unsigned long long edge_key(Coord* from, Coord* to, unsigned short depth);
+	/* Record a visit to a coordinate */
+	void visit(Coord* coord, unsigned short depth);
+};
+
+#endif
@@ -0,0 +1,222 @@
+#include <climits>
+#include <algorithm>
+
+#include "SIPPSearch.h"
+#include "Agent.h"
+#include "World.h"
+#include "Exceptions.h"
+#include "HashStruct.h"
+#include "CancelToken.h"
+
+/*
+* Constructor
+* @param p_coord: Coordinate of the node
+* @param p_interval: Index of the safe interval of the coordinate
+* @param p_arrival: Depth at which the coordinate is reached
+* @param p_parent: Index of the parent node, -1 for the start node
+*/
+SIPPNode::SIPPNode(Coord* p_coord, int p_interval, int p_arrival, int p_parent)
+{
+	coord = *p_coord;
+	interval = p_interval;
+	arrival = p_arrival;
+	parent = p_parent;
+}
+
+/*
+* Constructor, groups the agent's constraints by coordinate
+* @param search: The agent to find a path for
+*/
+SIPPSearch::SIPPSearch(Agent* search)
+{
+	world = search->get_world();
+	start = search->get_start();
+	goal = search->get_goal();
+	expansions = 0;
+	status = SEARCH_RUNNING;
+
+	std::unordered_map<unsigned int, Position>* constraints = search->get_constraints();
+	for (auto it = constraints->begin(); it != constraints->end(); it++)
+	{
+		Position constraint = it->second;
+		constrained_depths[HashStruct::coord_key(constraint.get_coord())].push_back(constraint.get_depth());
+	}
+	for (auto it = constrained_depths.begin(); it != constrained_depths.end(); it++)
+		std::sort(it->second.begin(), it->second.end());
+
+	cancel_token = search->get_cancel_token();
+}
+
+/*
+* Search for a path with A* over (coordinate, safe interval) states, where the
+* cost of a state is its earliest arrival depth
+* @return true if a path was found, false if the agent has no path
+*/
+bool SIPPSearch::sipp_search()
+{
+	/* The start is reached at depth 0, in its first safe interval if that is unconstrained */
+	std::vector<std::pair<int, int> >* start_intervals = get_intervals(start);
+	if (start_intervals->empty() || (*start_intervals)[0].first != 0)
+	{
+		status = SEARCH_INFEASIBLE;
+		return false;
+	}
+	open_node(start, 0, 0, -1);
+
+	while (!open_list.empty())
+	{
+		/* Make sure the search has not been cancelled or run out of time */
+		if (cancel_token != NULL && cancel_token->poll())
+		{
+			status = SEARCH_TIMEOUT;
+			return false;
+		}
+
+		int top = std::get<2>(open_list.top());
+		open_list.pop();
+
+		/* Skip states already expanded with an earlier arrival */
+		unsigned long long key = state_key(nodes[top].get_coord(), nodes[top].get_interval());
+		if (!closed_list.insert(key).second)
+			continue;
+		expansions++;
+
+		/* The agent leaves the world once it reaches its goal */
+		if (*nodes[top].get_coord() == *goal)
+		{
+			trace_path(top);
+			status = SEARCH_SOLVED;
+			return true;
+		}
+
+		/* Generate every move to a neighbouring coordinate (waiting happens in the interval) */
+		unsigned short x_coord = nodes[top].get_coord()->get_xcoord();
+		unsigned short y_coord = nodes[top].get_coord()->get_ycoord();
+		for (int x_diff = -1; x_diff <= 1; x_diff++)
+		{
+			for (int y_diff = -1; y_diff <= 1; y_diff++)
+			{
+				/* Coordinates must be non-negative */
+				if ((x_diff == 0 && y_diff == 0) ||
+					(x_coord == 0 && x_diff < 0) || (y_coord == 0 && y_diff < 0))
+					continue;
+
+				Coord succ = Coord(x_coord + x_diff, y_coord + y_diff);
+				if (world->check_coord(&succ))
+					generate(top, &succ);
+			}
+		}
+	}
+
+	/* The agent has no path under its constraints */
+	status = SEARCH_INFEASIBLE;
+	return false;
+}
+
+/*
+* Generate the successors of a node in one neighbouring coordinate. The agent
+* may wait until the end of its current interval before moving, so it can
+* enter every interval of the neighbour that starts before then.
+* @param parent: Index of the node being expanded
+* @param coord: The neighbouring coordinate
+*/
+void SIPPSearch::generate(int parent, Coord* coord)
+{
+	/* Earliest and latest arrival in the neighbour */
+	int earliest = nodes[parent].get_arrival() + 1;
+	std::pair<int, int> parent_interval =
+		(*get_intervals(nodes[parent].get_coord()))[nodes[parent].get_interval()];
+	int latest = parent_interval.second == INT_MAX ? INT_MAX : parent_interval.second + 1;
+
+	std::vector<std::pair<int, int> >* succ_intervals = get_intervals(coord);
+	int num_intervals = succ_intervals->size();
+	for (int i = 0; i < num_intervals; i++)
+	{
+		std::pair<int, int> interval = (*succ_intervals)[i];
+		if (interval.second < earliest)
+			continue;
+		if (interval.first > latest)
+			break;
+
+		/* Arrive as early as both intervals allow */
+		open_node(coord, i, std::max(earliest, interval.first), parent);
+	}
+}
+
+/*
+* Add a node to the OPEN list unless its state was already reached as early
+* @param coord: Coordinate of the node
+* @param interval: Index of the safe interval of the coordinate
+* @param arrival: Depth at which the coordinate is reached
+* @param parent: Index of the parent node, -1 for the start node
+*/
+void SIPPSearch::open_node(Coord* coord, int interval, int arrival, int parent)
+{
+	unsigned long long key = state_key(coord, interval);
+	auto it = best_arrival.find(key);
+	if (it != best_arrival.end() && it->second <= arrival)
+		return;
+	best_arrival[key] = arrival;
+
+	nodes.push_back(SIPPNode(coord, interval, arrival, parent));
+	int cost = arrival + coord->moves_to(goal);
+	open_list.push(std::make_tuple(cost, -arrival, static_cast<int>(nodes.size()) - 1));
+}
+
+/*
+* Safe intervals of a coordinate: the ranges of depths between its constraints
+* @param coord: The coordinate
+* @return the safe intervals, the last of which never ends (INT_MAX)
+*/
+std::vector<std::pair<int, int> >* SIPPSearch::get_intervals(Coord* coord)
+{
+	unsigned int key = HashStruct::coord_key(coord);
+	auto found = intervals.find(key);
+	if (found != intervals.end())
+		return &found->second;
+
+	std::vector<std::pair<int, int> >* coord_intervals = &intervals[key];
+	auto it = constrained_depths.find(key);
+
+	int interval_start = 0;
+	if (it != constrained_depths.end())
+	{
+		int num_depths = it->second.size();
+		for (int i = 0; i < num_depths; i++)
+		{
+			int depth = it->second[i];
+			if (depth > interval_start)
+				coord_intervals->push_back(std::make_pair(interval_start, depth - 1));
+			interval_start = depth + 1;
+		}
+	}
+	coord_intervals->push_back(std::make_pair(interval_start, INT_MAX));
+	return coord_intervals;
+}
+
+/*
+* Trace the path back from the goal node, waiting in each coordinate from its
+* arrival until the move into the next coordinate
+* @param goal_index: Index of the goal node
+*/
+void SIPPSearch::trace_path(int goal_index)
+{
+	path.push(*nodes[goal_index].get_coord());
+	for (int i = goal_index; nodes[i].get_parent() != -1; i = nodes[i].get_parent())
+	{
+		int parent = nodes[i].get_parent();
+		for (int depth = nodes[i].get_arrival() - 1; depth >= nodes[parent].get_arrival(); depth--)
+			path.push(*nodes[parent].get_coord());
+	}
+}
+
+/*
+* Pack a coordinate and one of its safe intervals into a single key
+* @param coord: The coordinate
+* @param interval: Index of the safe interval
+* @return a key unique to the state
+*/
+unsigned long long SIPPSearch::state_key(Coord* coord, int interval)
+{
+	return (static_cast<unsigned long long>(HashStruct::coord_key(coord)) << 32) | interval;
+}
@@ -0,0 +1,112 @@
+#ifndef SIPPSEARCH_H
+#define SIPPSEARCH_H
+
+#include <queue>
+#include <tuple>
+#include <stack>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "Macros.h"
+#include "Coordinates.h"
+#include "SearchStatus.h"
+
+class Agent;
+class CancelToken;
+class World;
+
+/*
+* A node of a SIPP search: a coordinate and one of its safe intervals, reached
+* at the earliest depth found so far, and the index of its parent node
+*/
+class SIPPNode
+{
+public:
+	/* Constructor */
+	SIPPNode(Coord* p_coord, int p_interval, int p_arrival, int p_parent);
+
+	/* Accessors */
+	Coord* get_coord() { return &coord; };
+	int get_interval() const { return interval; };
+	int get_arrival() const { return arrival; };
+	int get_parent() const { return parent; };
+private:
+	/* Coordinate of the node */
+	Coord coord;
+	/* Index of the safe interval of the coordinate */
+	int interval;
+	/* Depth at which the coordinate is reached */
+	int arrival;
+	/* Index of the parent node, -1 for the start node */
+	int parent;
+};
+
+/*
+* Safe interval path planning for one agent. A safe interval is a maximal
+* range of depths in which a coordinate is not constrained, and the search
+* states are (coordinate, safe interval) pairs rather than (coordinate, depth)
+* pairs. Waiting happens inside an interval, so a state is only expanded once
+* no matter how long the agent waits. The path found has the optimal cost.
+*/
+class SIPPSearch
+{
+public:
+	/* Constructor */
+	SIPPSearch(Agent* search);
+
+	/* Search for a path, return false if the agent has no path */
+	bool sipp_search();
+
+	/* Accessors */
+	std::stack<Coord>* get_path() { return &path; };
+	int get_expansions() const { return expansions; };
+	SearchStatus get_status() const { return status; };
+private:
+	/* Outcome of the search */
+	SearchStatus status;
+	/* Pointer to the world of agents */
+	World* world;
+	/* Start and goal coordinates of the agent */
+	Coord* start;
+	Coord* goal;
+
+	/* Sorted constrained depths of each constrained coordinate */
+	std::unordered_map<unsigned int, std::vector<int> > constrained_depths;
+	/* Safe intervals of each coordinate reached so far */
+	std::unordered_map<unsigned int, std::vector<std::pair<int, int> > > intervals;
+
+	/* Every node generated, referenced by index */
+	std::vector<SIPPNode> nodes;
+	/* OPEN list ordered by (cost, -arrival, node index) */
+	std::priority_queue<
+		std::tuple<int, int, int>, std::vector<std::tuple<int, int, int> >,
+		std::greater<std::tuple<int, int, int> >
+		> open_list;
+	/* Earliest arrival found for each (coordinate, interval) state */
+	std::unordered_map<unsigned long long, int> best_arrival;
+	/* States already expanded */
+	std::unordered_set<unsigned long long> closed_list;
+
+	/* Solution path and number of nodes expanded */
+	std::stack<Coord> path;
+	int expansions;
+
+	/* Deadline and cancellation flag of the agent's CBS Tree, NULL if there is none */
+	CancelToken* cancel_token;
+
+	/* Safe intervals of a coordinate, built the first time it is reached */
+	std::vector<std::pair<int, int> >* get_intervals(Coord* coord);
+	/* Generate the successors of a node in one neighbouring coordinate */
+	void generate(int parent, Coord* coord);
+	/* Add a node to the OPEN list unless its state was reached earlier */
+	void open_node(Coord* coord, int interval, int arrival, int parent);
+	/* Trace the path back from the goal node */
+	void trace_path(int goal_index);
+	/* Pack a coordinate and interval into a key */
+	static unsigned long long state_key(Coord* coord, int interval);
+};
+
+#endif
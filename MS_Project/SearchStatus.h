@@ -0,0 +1,36 @@
+#ifndef SEARCHSTATUS_H
+#define SEARCHSTATUS_H
+
+/*
+* Outcome of a search. Searches report these instead of throwing, so routine
+* outcomes such as an infeasible child never unwind the stack.
+*/
+enum SearchStatus
+{
+	/* The search has not finished */
+	SEARCH_RUNNING,
+	/* A solution was found */
+	SEARCH_SOLVED,
+	/* No solution exists */
+	SEARCH_INFEASIBLE,
+	/*
+	* No solution was found above SEARCH_DEPTH, but the depth bound of the
+	* agent was capped by SEARCH_DEPTH so a deeper solution may exist
+	*/
+	SEARCH_DEPTH_EXCEEDED,
+	/* The deadline (TIME_LIMIT) passed or the search was cancelled */
+	SEARCH_TIMEOUT,
+	/* The limit on the number of CBSNode expansions was reached */
+	SEARCH_EXPANSION_LIMIT,
+	/* Memory ran out */
+	SEARCH_MEMORY_LIMIT,
+	/* The search keeps no OPEN and CLOSED lists to continue (SIPP, LPA* and focal agents) */
+	SEARCH_UNSUPPORTED,
+	/*
+	* Prioritized planning left an agent without a path. Planning in a fixed
+	* order is incomplete, so a solution may still exist.
+	*/
+	SEARCH_PRIORITY_FAILED
+};
+
+#endif
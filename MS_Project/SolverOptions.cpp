@@ -0,0 +1,341 @@
+#include <cstdlib>
+#include <climits>
+
+#include "SolverOptions.h"
+#include "Exceptions.h"
+#include "Macros.h"
+
+/* Suboptimality factor of ECBS when it is chosen without one */
+static const double DEFAULT_ECBS_WEIGHT = 1.5;
+
+/*
+* Weights of the adaptive repair policy, tuned with --compare on the test files: a
+* fresh expansion generates and hashes up to nine successors, about eight copies,
+* while a node PCA* removes costs about one more copy to remove and expand again
+*/
+static const double DEFAULT_RESTART_WEIGHT = 8;
+static const double DEFAULT_REMOVAL_WEIGHT = 1;
+
+/* Smaller layers are removed faster by one thread than by starting several */
+static const unsigned int DEFAULT_PARALLEL_LAYER_SIZE = 2048;
+
+/* Positions deeper than SEARCH_DEPTH cannot be created, so no search may go deeper */
+#ifdef SEARCH_DEPTH
+static const unsigned short MAX_SEARCH_DEPTH = SEARCH_DEPTH;
+#else
+static const unsigned short MAX_SEARCH_DEPTH = USHRT_MAX - 1;
+#endif
+
+/*
+* Constructor, every option takes its default from Macros.h
+*/
+SolverOptions::SolverOptions()
+{
+#if defined(CBS_CLASSIC)
+	repair = REPAIR_NEVER;
+#elif defined(ADAPTIVE_REPAIR)
+	repair = REPAIR_ADAPTIVE;
+#elif defined(LPA_STAR_REPAIR)
+	repair = REPAIR_LPA_STAR;
+#else
+	repair = REPAIR_ALWAYS;
+#endif
+	restart_weight = DEFAULT_RESTART_WEIGHT;
+	removal_weight = DEFAULT_REMOVAL_WEIGHT;
+
+#ifdef REMOVAL_THREADS
+	removal_threads = REMOVAL_THREADS;
+#else
+	removal_threads = 1;
+#endif
+	parallel_layer_size = DEFAULT_PARALLEL_LAYER_SIZE;
+
+#ifdef COLLAPSE_STATES
+	collapse_states = true;
+#else
+	collapse_states = false;
+#endif
+
+	/* Only the A* Search enforces landmarks */
+#if defined(DISJOINT_SPLITTING) && !defined(SIPP_SEARCH)
+	disjoint_splitting = true;
+#else
+	disjoint_splitting = false;
+#endif
+
+#ifdef CORRIDOR_REASONING
+	corridor_reasoning = true;
+#else
+	corridor_reasoning = false;
+#endif
+
+	/* Only the A* Search enforces length constraints */
+#if defined(TARGET_REASONING) && !defined(SIPP_SEARCH)
+	target_reasoning = true;
+#else
+	target_reasoning = false;
+#endif
+
+#ifdef TIME_LIMIT
+	time_limit = TIME_LIMIT;
+#else
+	time_limit = 0;
+#endif
+
+	search_depth = MAX_SEARCH_DEPTH;
+
+	/* The high level search */
+#if defined(ECBS_WEIGHT)
+	solver = SOLVER_ECBS;
+	ecbs_weight = ECBS_WEIGHT;
+#else
+	ecbs_weight = DEFAULT_ECBS_WEIGHT;
+#if defined(ANYTIME_LNS)
+	solver = SOLVER_LNS;
+#elif defined(PRIORITIZED_PLANNING)
+	solver = SOLVER_PRIORITIZED;
+#else
+	solver = SOLVER_CBS;
+#endif
+#endif
+
+#ifdef WARM_START
+	warm_start = true;
+#else
+	warm_start = false;
+#endif
+
+#ifdef MEMORY_BUDGET
+	memory_budget = MEMORY_BUDGET;
+#else
+	memory_budget = 0;
+#endif
+
+#ifdef PATH_CACHE_SIZE
+	path_cache_size = PATH_CACHE_SIZE;
+#else
+	path_cache_size = 0;
+#endif
+
+#ifdef NUM_TESTS
+	num_tests = NUM_TESTS;
+#else
+	num_tests = 0;
+#endif
+
+#ifdef TEST_RUN_COUNT
+	test_run_count = TEST_RUN_COUNT;
+#else
+	test_run_count = 1;
+#endif
+
+	compare = false;
+}
+
+/*
+* Override the defaults from command line arguments
+* @param argc: Number of arguments, including the program name
+* @param argv: The arguments
+* @exceptions: Throws a TerminalException if an argument is not recognized or
+* its value is out of range
+*/
+void SolverOptions::parse(int argc, char** argv)
+{
+	/* Splitting options given on the command line, rather than by Macros.h */
+	bool disjoint_given = false;
+	bool corridor_given = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string option = argv[i];
+
+		/* Options without a value */
+		if (option == "--classic")
+			repair = REPAIR_NEVER;
+		else if (option == "--fdr")
+			repair = REPAIR_ALWAYS;
+		else if (option == "--adaptive")
+			repair = REPAIR_ADAPTIVE;
+		else if (option == "--lpa")
+			repair = REPAIR_LPA_STAR;
+		else if (option == "--collapse")
+			collapse_states = true;
+		else if (option == "--no-collapse")
+			collapse_states = false;
+		else if (option == "--disjoint")
+		{
+			disjoint_splitting = true;
+			disjoint_given = true;
+		}
+		else if (option == "--corridor")
+		{
+			corridor_reasoning = true;
+			corridor_given = true;
+		}
+		else if (option == "--target")
+			target_reasoning = true;
+		else if (option == "--warm-start")
+			warm_start = true;
+		else if (option == "--compare")
+			compare = true;
+		else
+		{
+			/* Every other option takes a value */
+			if (i + 1 >= argc)
+				throw TerminalException("OPTION ERROR 1: " + option + " is unknown or has no value.");
+			char* value = argv[++i];
+
+			if (option == "--time-limit")
+				time_limit = parse_number(option, value, 0, 1e9);
+			else if (option == "--search-depth")
+				search_depth = static_cast<unsigned short>(parse_number(option, value, 1, MAX_SEARCH_DEPTH));
+			else if (option == "--weight")
+				ecbs_weight = parse_number(option, value, 1, 1e9);
+			else if (option == "--restart-weight")
+				restart_weight = parse_number(option, value, 0, 1e9);
+			else if (option == "--removal-weight")
+				removal_weight = parse_number(option, value, 0, 1e9);
+			else if (option == "--removal-threads")
+				removal_threads = static_cast<unsigned int>(parse_number(option, value, 1, 256));
+			else if (option == "--parallel-layer")
+				parallel_layer_size = static_cast<unsigned int>(parse_number(option, value, 1, UINT_MAX));
+			else if (option == "--memory-budget")
+				memory_budget = static_cast<unsigned long>(parse_number(option, value, 0, 1e15));
+			else if (option == "--path-cache")
+				path_cache_size = static_cast<unsigned int>(parse_number(option, value, 0, UINT_MAX));
+			else if (option == "--tests")
+				num_tests = static_cast<int>(parse_number(option, value, 0, INT_MAX));
+			else if (option == "--runs")
+				test_run_count = static_cast<int>(parse_number(option, value, 1, INT_MAX));
+			else if (option == "--solver")
+			{
+				std::string name = value;
+				if (name == "cbs")
+					solver = SOLVER_CBS;
+				else if (name == "ecbs")
+					solver = SOLVER_ECBS;
+				else if (name == "lns")
+					solver = SOLVER_LNS;
+				else if (name == "pp")
+					solver = SOLVER_PRIORITIZED;
+				else
+					throw TerminalException("OPTION ERROR 2: Unknown solver " + name + ".");
+			}
+			else
+				throw TerminalException("OPTION ERROR 3: Unknown option " + option + ".");
+		}
+	}
+
+	/* Only the CBS variants differ in how agents are repaired */
+	if (compare && solver != SOLVER_CBS)
+		throw TerminalException("OPTION ERROR 4: --compare only applies to the cbs solver.");
+
+	/*
+	* The other solvers split conflicts one depth at a time and let finished agents
+	* leave. Asking for more is an error, the defaults of Macros.h are dropped.
+	*/
+	if (solver != SOLVER_CBS && (disjoint_given || corridor_given))
+		throw TerminalException("OPTION ERROR 8: --disjoint and --corridor only apply to the cbs solver.");
+	if (solver != SOLVER_CBS)
+	{
+		disjoint_splitting = false;
+		corridor_reasoning = false;
+		target_reasoning = false;
+	}
+
+	/* Landmarks and length constraints are only enforced by the A* Search */
+#ifdef SIPP_SEARCH
+	bool a_star = false;
+#else
+	bool a_star = repair != REPAIR_LPA_STAR;
+#endif
+	if (disjoint_splitting && !a_star)
+		throw TerminalException("OPTION ERROR 6: --disjoint needs the A* Search.");
+	if (target_reasoning && !a_star)
+		throw TerminalException("OPTION ERROR 7: --target needs the A* Search.");
+}
+
+/*
+* Parse the value of an option
+* @param option: The option the value belongs to
+* @param value: The value as given on the command line
+* @param min: The smallest value allowed
+* @param max: The largest value allowed
+* @return the value
+*/
+double SolverOptions::parse_number(std::string option, char* value, double min, double max)
+{
+	char* end;
+	double number = std::strtod(value, &end);
+	if (end == value || *end != '\0' || number < min || number > max)
+		throw TerminalException("OPTION ERROR 5: Invalid value for " + option + ".");
+	return number;
+}
+
+/*
+* Description of the command line arguments
+* @return the usage text
+*/
+std::string SolverOptions::usage()
+{
+	return
+		"Options (defaults from Macros.h):\n"
+		"  --classic | --fdr | --adaptive | --lpa  search agents again from scratch, repair\n"
+		"                           them with PCA*, pick the cheaper of the two per agent,\n"
+		"                           or repair an incremental LPA* search\n"
+		"  --restart-weight W       cost of a fresh expansion relative to copying a node\n"
+		"  --removal-weight W       cost of a node PCA* removes relative to copying it\n"
+		"  --removal-threads N      threads removing the descendants of a new constraint\n"
+		"  --parallel-layer NODES   fewest nodes of a depth layer removed in parallel\n"
+		"  --collapse | --no-collapse  drop repeated states past the latest constraint\n"
+		"  --disjoint               split conflicts with a positive and a negative constraint\n"
+		"  --corridor               resolve conflicts inside corridors with ranges of constraints\n"
+		"  --target                 keep finished agents at their goals, with length constraints\n"
+		"  --time-limit SECONDS     stop a search after SECONDS, 0 for no limit\n"
+		"  --search-depth DEPTH     deepest position an agent generates, at most SEARCH_DEPTH\n"
+		"  --solver cbs|ecbs|lns|pp high level search\n"
+		"  --weight W               suboptimality factor of ecbs\n"
+		"  --warm-start             bound cbs by the cost of a prioritized plan\n"
+		"  --memory-budget NODES    A* Nodes kept in memory, 0 for no limit\n"
+		"  --path-cache SIZE        low level results kept for reuse, 0 to disable\n"
+		"  --tests N                number of test files to time\n"
+		"  --runs N                 number of times each test is run\n"
+		"  --compare                time FDR-CBS, classic CBS, adaptive repair and LPA-CBS\n"
+		"                           on the same worlds\n";
+}
+
+/*
+* Options used by agents created without any
+* @return the options built from Macros.h
+*/
+const SolverOptions* SolverOptions::get_defaults()
+{
+	static const SolverOptions defaults = SolverOptions();
+	return &defaults;
+}
+
+/*
+* Name of the solver configured, used to label results
+* @return the name
+*/
+std::string SolverOptions::get_name() const
+{
+	switch (solver)
+	{
+	case SOLVER_ECBS:
+		return "ECBS";
+	case SOLVER_LNS:
+		return "LNS";
+	case SOLVER_PRIORITIZED:
+		return "PP";
+	default:
+		/* Disjoint splitting, corridor and target reasoning label the repair policy they run with */
+		std::string prefix = std::string(disjoint_splitting ? "DS-" : "") +
+			(corridor_reasoning ? "CR-" : "") + (target_reasoning ? "TR-" : "");
+		if (repair == REPAIR_NEVER)
+			return prefix + "CBS";
+		if (repair == REPAIR_LPA_STAR)
+			return prefix + "LPA-CBS";
+		return prefix + (repair == REPAIR_ADAPTIVE ? "ADAPTIVE-CBS" : "FDR-CBS");
+	}
+}
@@ -0,0 +1,97 @@
+#ifndef SOLVEROPTIONS_H
+#define SOLVEROPTIONS_H
+
+#include <string>
+
+/* High level search used to solve a MAPF problem */
+enum SolverType
+{
+	/* Optimal CBS, agents are repaired with PCA* (FDR-CBS) as the repair policy allows */
+	SOLVER_CBS,
+	/* Bounded suboptimal ECBS */
+	SOLVER_ECBS,
+	/* Anytime large neighborhood search */
+	SOLVER_LNS,
+	/* Prioritized planning */
+	SOLVER_PRIORITIZED
+};
+
+/* How a child agent gets the search state of its parent under a new constraint */
+enum RepairPolicy
+{
+	/* Copy the parent's lists and remove the constraint's descendants with PCA* (FDR-CBS) */
+	REPAIR_ALWAYS,
+	/* Search again from the start (classic CBS) */
+	REPAIR_NEVER,
+	/* Pick whichever of the two is estimated to be cheaper for each child */
+	REPAIR_ADAPTIVE,
+	/* Copy the parent's LPA* search and search again only the states the constraint changes */
+	REPAIR_LPA_STAR
+};
+
+/*
+* Run time configuration of the solvers. The defaults come from Macros.h and
+* are overridden from the command line, so one binary can run (and compare)
+* every configuration. Debug output toggles stay in Macros.h.
+*/
+class SolverOptions
+{
+public:
+	/* Constructor, every option takes its default from Macros.h */
+	SolverOptions();
+
+	/* Override the defaults from command line arguments */
+	void parse(int argc, char** argv);
+	/* Description of the command line arguments */
+	static std::string usage();
+	/* Options used by agents created without any */
+	static const SolverOptions* get_defaults();
+	/* Name of the solver configured, used to label results */
+	std::string get_name() const;
+
+	/* How child agents are searched (CBS_CLASSIC, ADAPTIVE_REPAIR, LPA_STAR_REPAIR) */
+	RepairPolicy repair;
+	/* Cost of expanding a node in a fresh search relative to copying one, for the adaptive policy */
+	double restart_weight;
+	/* Cost of removing and searching again a copied node relative to copying one, for the adaptive policy */
+	double removal_weight;
+	/* Threads removing the descendants of a new constraint, 1 to remove them serially (REMOVAL_THREADS) */
+	unsigned int removal_threads;
+	/* Fewest nodes of one depth layer worth removing in parallel */
+	unsigned int parallel_layer_size;
+	/* Drop states past the latest constraint that repeat an earlier cell (COLLAPSE_STATES) */
+	bool collapse_states;
+	/* Split CBSNodes with a positive and a negative constraint, A* Search only (DISJOINT_SPLITTING) */
+	bool disjoint_splitting;
+	/* Resolve conflicts inside corridors with ranges of constraints (CORRIDOR_REASONING) */
+	bool corridor_reasoning;
+	/* Keep agents at their goals once they finish, CBS with the A* Search only (TARGET_REASONING) */
+	bool target_reasoning;
+	/* Seconds a tree may search for, 0 for no limit (TIME_LIMIT) */
+	double time_limit;
+	/* Deepest position an agent generates (SEARCH_DEPTH) */
+	unsigned short search_depth;
+
+	/* High level search (ECBS_WEIGHT, ANYTIME_LNS, PRIORITIZED_PLANNING) */
+	SolverType solver;
+	/* Suboptimality factor of ECBS (ECBS_WEIGHT) */
+	double ecbs_weight;
+	/* Bound CBS by the cost of a prioritized plan (WARM_START) */
+	bool warm_start;
+	/* A* Nodes a tree keeps in memory, 0 for no limit (MEMORY_BUDGET) */
+	unsigned long memory_budget;
+	/* Low level results a tree keeps for reuse, 0 to disable the cache (PATH_CACHE_SIZE) */
+	unsigned int path_cache_size;
+
+	/* Number of test files to time, 0 to time none (NUM_TESTS) */
+	int num_tests;
+	/* Number of times each test is run (TEST_RUN_COUNT) */
+	int test_run_count;
+	/* Time FDR-CBS, classic CBS, the adaptive policy and LPA-CBS on the same worlds */
+	bool compare;
+private:
+	/* Parse the value of an option */
+	static double parse_number(std::string option, char* value, double min, double max);
+};
+
+#endif
@@ -9,7 +9,22 @@
 #include "Exceptions.h"
 #include "Agent.h"
 #include "CBSNode.h"
+#include "ConflictKernel.h"
+#include "ConflictMatrix.h"
 #include "CBSTree.h"
+#include "ECBSTree.h"
+#include "LNSTree.h"
+#include "PrioritizedTree.h"
+#include "PrioritizedPlanner.h"
+#include "ReservationTable.h"
+#include "SIPPSearch.h"
+#include "CancelToken.h"
+#include "SolverOptions.h"
+#include "PathClearAStar.h"
+#include "PathClearWorkspace.h"
+#include "DescendantRemoval.h"
+#include "LPAStarSearch.h"
+#include "AStarNodeMultiMap.h"
 #include "Macros.h"
 
 /* 
@@ -50,11 +65,115 @@ bool Tests::run_tests()
 		std::cout << "Path Clear A* Tests Passed." << std::endl;
 #endif
 
+	if (!eviction_tests())
+		return false;
+	else
+		std::cout << "Eviction Tests Passed." << std::endl;
+
+	if (!sipp_tests())
+		return false;
+	else
+		std::cout << "SIPP Tests Passed." << std::endl;
+
+	if (!reachability_tests())
+		return false;
+	else
+		std::cout << "Reachability Tests Passed." << std::endl;
+
+	if (!status_tests())
+		return false;
+	else
+		std::cout << "Status Tests Passed." << std::endl;
+
+	if (!cancel_token_tests())
+		return false;
+	else
+		std::cout << "Cancel Token Tests Passed." << std::endl;
+
+	if (!solver_options_tests())
+		return false;
+	else
+		std::cout << "Solver Options Tests Passed." << std::endl;
+
+#ifndef SIPP_SEARCH
+	if (!repair_policy_tests())
+		return false;
+	else
+		std::cout << "Repair Policy Tests Passed." << std::endl;
+
+	if (!descendant_removal_tests())
+		return false;
+	else
+		std::cout << "Descendant Removal Tests Passed." << std::endl;
+
+	if (!path_clear_workspace_tests())
+		return false;
+	else
+		std::cout << "PCA* Workspace Tests Passed." << std::endl;
+
+	if (!lpa_star_tests())
+		return false;
+	else
+		std::cout << "LPA* Tests Passed." << std::endl;
+
+	if (!continued_search_tests())
+		return false;
+	else
+		std::cout << "Continued Search Tests Passed." << std::endl;
+
+	if (!disjoint_splitting_tests())
+		return false;
+	else
+		std::cout << "Disjoint Splitting Tests Passed." << std::endl;
+
+	if (!corridor_reasoning_tests())
+		return false;
+	else
+		std::cout << "Corridor Reasoning Tests Passed." << std::endl;
+
+	if (!target_reasoning_tests())
+		return false;
+	else
+		std::cout << "Target Reasoning Tests Passed." << std::endl;
+#endif
+
+	if (!conflict_kernel_tests())
+		return false;
+	else
+		std::cout << "Conflict Kernel Tests Passed." << std::endl;
+
+	if (!conflict_matrix_tests())
+		return false;
+	else
+		std::cout << "Conflict Matrix Tests Passed." << std::endl;
+
+#if defined(COLLAPSE_STATES) && !defined(SIPP_SEARCH) && !defined(LPA_STAR_REPAIR)
+	if (!collapse_tests())
+		return false;
+	else
+		std::cout << "Collapse Tests Passed." << std::endl;
+#endif
+
 	if (!cbs_node_tests())
 		return false;
 	else
 		std::cout << "CBSNode Tests Passed." << std::endl;
 
+	if (!ecbs_tree_tests())
+		return false;
+	else
+		std::cout << "ECBSTree Tests Passed." << std::endl;
+
+	if (!lns_tree_tests())
+		return false;
+	else
+		std::cout << "LNSTree Tests Passed." << std::endl;
+
+	if (!prioritized_planner_tests())
+		return false;
+	else
+		std::cout << "Prioritized Planner Tests Passed." << std::endl;
+
 	if (!cbs_tree_tests())
 		return false;
 	else
@@ -332,6 +451,31 @@ bool Tests::world_tests()
 		delete coords[j];
 	delete test_world;
 
+	/* Two separate corridors, the middle of the first one separates its ends */
+	empty_file.open(test_file);
+	empty_file << "1110011";
+	empty_file.close();
+	test_world = new World(test_file);
+
+	Coord left(0, 0), middle(1, 0), right(2, 0), other(5, 0);
+	if (!test_world->connected(&left, &right) || test_world->connected(&left, &other) ||
+		test_world->get_component_size(&left) != 3 || test_world->get_component_size(&other) != 2)
+	{
+		std::cout << "FAILED: Connected components are not correct." << std::endl;
+		delete test_world;
+		std::remove(test_file);
+		return false;
+	}
+	if (!test_world->is_articulation_point(&middle) || test_world->is_articulation_point(&left) ||
+		test_world->is_articulation_point(&other))
+	{
+		std::cout << "FAILED: Articulation points are not correct." << std::endl;
+		delete test_world;
+		std::remove(test_file);
+		return false;
+	}
+	delete test_world;
+
 	/* Remove the test file */
 	std::remove(test_file);
 
@@ -375,11 +519,7 @@ bool Tests::a_star_tests()
 	Coord goal = Coord(2, 0);
 
 	/* Create the A* Search */
-#ifdef TIME_LIMIT
-	Agent* search = new Agent(&start, &goal, test_world, "agent_name", std::clock());
-#else
 	Agent* search = new Agent(&start, &goal, test_world, "agent_name");
-#endif
 
 	/* Get the solution */
 	std::stack<Coord> path = search->get_solution();
@@ -448,11 +588,7 @@ bool Tests::path_clear_a_star_tests()
 	Coord goal = Coord(2, 0);
 
 	/* Create the A* Search and find the solution */
-#ifdef TIME_LIMIT
-	Agent* search = new Agent(&start, &goal, test_world, "agent_name",std::clock());
-#else
 	Agent* search = new Agent(&start, &goal, test_world, "agent_name");
-#endif
 	search->find_solution();
 
 	/* 
@@ -529,6 +665,67 @@ bool Tests::path_clear_a_star_tests()
 	return true;
 }
 
+/*
+* Agent eviction and regeneration
+* @return true if all tests pass or print an error and return false if one test fails.
+*/
+bool Tests::eviction_tests()
+{
+	/* Create a world */
+	World* test_world = create_world();
+
+	/* Create the start and goal coordinates */
+	Coord start = Coord(0, 0);
+	Coord goal = Coord(2, 0);
+
+	/* Create the A* Search and find the solution */
+	Agent* search = new Agent(&start, &goal, test_world, "agent_name");
+	search->find_solution();
+	std::stack<Coord> path = search->get_solution();
+
+	/* An evicted agent keeps its path and cost */
+	search->evict();
+	if (!search->is_evicted() || search->get_cost() != 2 || search->get_solution() != path)
+	{
+		std::cout << "FAILED: Evicted agent lost its solution." << std::endl;
+		delete search;
+		delete test_world;
+		return false;
+	}
+
+	/* A child of an evicted agent searches from scratch under both constraints */
+	Position constraint = Position(1, 0, 1);
+	Agent* constrained_search = new Agent(search, &constraint);
+	if (constrained_search->get_cost() != 3)
+	{
+		std::cout << "FAILED: Child of an evicted agent has the wrong cost." << std::endl;
+		delete search;
+		delete constrained_search;
+		delete test_world;
+		return false;
+	}
+
+	/* A restored agent finds the same path again, SIPP agents only keep their path */
+#ifndef SIPP_SEARCH
+	search->restore();
+	if (search->is_evicted() || search->get_solution() != path)
+	{
+		std::cout << "FAILED: Restored agent has a different solution." << std::endl;
+		delete search;
+		delete constrained_search;
+		delete test_world;
+		return false;
+	}
+#endif
+
+	/* Clean up */
+	delete search;
+	delete constrained_search;
+	delete test_world;
+
+	return true;
+}
+
 /* 
 * Create a 1x3 world with no obstacles 
 * @return a pointer to a 1x3 world with no obstacles 
@@ -578,21 +775,13 @@ bool Tests::cbs_node_tests()
 	Coord start_1 = Coord(0, 0);
 	Coord goal_1 = Coord(2, 0);
 	std::string name_1 = "Agent 1";
-#ifdef TIME_LIMIT
-	Agent* a_1 = new Agent(&start_1, &goal_1, test_world, name_1,std::clock());
-#else
 	Agent* a_1 = new Agent(&start_1, &goal_1, test_world, name_1);
-#endif
 
 	/* Create second agent */
 	Coord start_2 = Coord(2, 0);
 	Coord goal_2 = Coord(0, 0);
 	std::string name_2 = "Agent 2";
-#ifdef TIME_LIMIT
-	Agent* a_2 = new Agent(&start_2, &goal_2, test_world, name_2,std::clock());
-#else
 	Agent* a_2 = new Agent(&start_2, &goal_2, test_world, name_2);
-#endif
 
 	/* Create a vector containing both agents */
 	std::vector<Agent*> agents = std::vector<Agent*>();
@@ -803,41 +992,1488 @@ void Tests::cbs_tree_cleanup(Coord* c0, Coord* c1, Coord* c2)
 }
 
 /*
-* Create a 3x3 world with no obstacles
-* @return a string file name for the newly created world file
+* Tests for the safe interval search
+* @return true if all tests pass or print an error and return false if one test fails
 */
-std::string Tests::create_world_file()
+bool Tests::sipp_tests()
 {
-	/* Name of the world file */
-	char test_file[] = "Worlds/test_file.txt";
+	/* Create a world */
+	World* test_world = create_world();
 
-	/* Create the world */
-	std::ofstream file(test_file);
-	file << "111\n";
-	file << "111\n";
-	file << "111\n";
-	file.close();
+	/* Create the start and goal coordinates */
+	Coord start = Coord(0, 0);
+	Coord goal = Coord(2, 0);
 
-	return std::string(test_file);
+	/* The middle coordinate is constrained at depths 1 and 2 */
+	Agent* search = new Agent(&start, &goal, test_world, "agent_name");
+	Position constraint_1 = Position(1, 0, 1);
+	Position constraint_2 = Position(1, 0, 2);
+	search->add_conflict(&constraint_1);
+	search->add_conflict(&constraint_2);
+
+	/* The agent waits at the start until the middle is safe */
+	SIPPSearch sipp = SIPPSearch(search);
+	if (!sipp.sipp_search() || sipp.get_path()->size() != 5)
+	{
+		std::cout << "FAILED: SIPP path has the wrong cost." << std::endl;
+		delete search;
+		delete test_world;
+		return false;
+	}
+
+	/* Waiting in place is a single state, so only three states are expanded */
+	std::stack<Coord> path = *sipp.get_path();
+	Coord c0 = Coord(0, 0);
+	Coord c1 = Coord(1, 0);
+	if (sipp.get_expansions() != 3 || !check_top_coord(path, &c0) ||
+		!check_top_coord(path, &c0) || !check_top_coord(path, &c0) ||
+		!check_top_coord(path, &c1) || !check_top_coord(path, &goal))
+	{
+		std::cout << "FAILED: SIPP path is not correct." << std::endl;
+		delete search;
+		delete test_world;
+		return false;
+	}
+
+	/* The agent finds the same cost with its own search */
+	if (search->get_cost() != 4)
+	{
+		std::cout << "FAILED: SIPP and agent costs differ." << std::endl;
+		delete search;
+		delete test_world;
+		return false;
+	}
+
+	delete search;
+	delete test_world;
+	return true;
 }
 
 /*
-* Create a file containing several agents 
-* @return a string file name for the newly created agent file
+* Tests for rejecting agents that cannot reach their goal without searching
+* @return true if all tests pass or print an error and return false if one test fails
 */
-std::string Tests::create_agent_file()
+bool Tests::reachability_tests()
 {
-	/* Name of the agent file */
-	char test_file[] = "Agents/agent_file.txt";
+	/* Create a world */
+	World* test_world = create_world();
 
-	/* Create 3 agents */
-	std::ofstream file(test_file);
-	file << "Agent_1 (0,0) (2,2)\n";
-	file << "Agent_2 (1,0) (1,2)\n";
-	file << "Agent_3 (2,2) (0,1)\n";
-	file.close();
+	/* Create the start and goal coordinates */
+	Coord start = Coord(0, 0);
+	Coord goal = Coord(2, 0);
+	Agent* search = new Agent(&start, &goal, test_world, "agent_name");
 
-	return std::string(test_file);
+	/* Blocking every cell the agent can move to at depth 1 cuts it off from its goal */
+	Position start_block = Position(0, 0, 1);
+	Position middle_block = Position(1, 0, 1);
+	if (!search->can_reach_goal(&middle_block))
+	{
+		std::cout << "FAILED: Reachable goal reported as unreachable." << std::endl;
+		delete search;
+		delete test_world;
+		return false;
+	}
+
+	/* A range of constraints is checked as a whole */
+	std::vector<Position> block_range = std::vector<Position>();
+	block_range.push_back(start_block);
+	block_range.push_back(middle_block);
+	if (search->can_reach_goal(&block_range))
+	{
+		std::cout << "FAILED: Range of constraints left the goal reachable." << std::endl;
+		delete search;
+		delete test_world;
+		return false;
+	}
+	search->add_conflict(&start_block);
+	if (search->can_reach_goal(&middle_block))
+	{
+		std::cout << "FAILED: Unreachable goal reported as reachable." << std::endl;
+		delete search;
+		delete test_world;
+		return false;
+	}
+
+	/* The depth bound is the horizon plus the distance plus the component size */
+	if (search->get_depth_bound() != 1 + 2 + 3)
+	{
+		std::cout << "FAILED: Depth bound is not correct." << std::endl;
+		delete search;
+		delete test_world;
+		return false;
+	}
+
+	/* A search that runs out of nodes reports the agent as infeasible */
+	search->add_conflict(&middle_block);
+	bool solved = true;
+	try
+	{
+		search->find_solution();
+	}
+	catch (OutOfNodesException& ex)
+	{
+		solved = false;
+	}
+	if (solved || search->get_status() != SEARCH_INFEASIBLE)
+	{
+		std::cout << "FAILED: Trapped agent is not reported as infeasible." << std::endl;
+		delete search;
+		delete test_world;
+		return false;
+	}
+
+	delete search;
+	delete test_world;
+	return true;
+}
+
+/*
+* Tests for reporting search outcomes as status codes rather than exceptions
+* @return true if all tests pass or print an error and return false if one test fails
+*/
+bool Tests::status_tests()
+{
+	/* Create a world */
+	World* test_world = create_world();
+
+	/* Create two agents swapping ends of the corridor */
+	Coord start_1 = Coord(0, 0);
+	Coord goal_1 = Coord(2, 0);
+	Coord start_2 = Coord(2, 0);
+	Coord goal_2 = Coord(0, 0);
+	Agent* a_1 = new Agent(&start_1, &goal_1, test_world, "Agent 1");
+	Agent* a_2 = new Agent(&start_2, &goal_2, test_world, "Agent 2");
+
+	/* The first agent may not wait, so blocking the middle of the corridor traps it */
+	Position start_block = Position(0, 0, 1);
+	a_1->add_conflict(&start_block);
+	std::vector<Agent*> agents = std::vector<Agent*>();
+	agents.push_back(a_1);
+	agents.push_back(a_2);
+	CBSNode* root = new CBSNode(&agents);
+	if (root->get_status() != SEARCH_SOLVED)
+	{
+		std::cout << "FAILED: Root node with feasible agents is not solved." << std::endl;
+		delete root;
+		delete a_1;
+		delete a_2;
+		delete test_world;
+		return false;
+	}
+
+	/* A child whose agent has no path reports it without throwing and shares nothing */
+	Position middle_block = Position(1, 0, 1);
+	CBSNode* child = new CBSNode(root, 0, &middle_block);
+	if (child->get_status() != SEARCH_INFEASIBLE || (*child->get_owned())[0] ||
+		(*child->get_agents())[0] != a_1)
+	{
+		std::cout << "FAILED: Infeasible child node is not reported as infeasible." << std::endl;
+		delete child;
+		delete root;
+		delete a_1;
+		delete a_2;
+		delete test_world;
+		return false;
+	}
+	delete child;
+	delete root;
+	delete a_1;
+	delete a_2;
+
+	/* A tree stopped by its expansion limit reports the limit, the tree deletes the agents */
+	a_1 = new Agent(&start_1, &goal_1, test_world, "Agent 1");
+	a_2 = new Agent(&start_2, &goal_2, test_world, "Agent 2");
+	agents[0] = a_1;
+	agents[1] = a_2;
+	CBSTree* tree = new CBSTree(test_world, &agents);
+	tree->set_expansion_limit(1);
+	if (
+		tree->solve() != NULL || tree->get_status() != SEARCH_EXPANSION_LIMIT ||
+		tree->get_cbs_expansions() != 1
+		)
+	{
+		std::cout << "FAILED: Expansion limit is not reported as the search status." << std::endl;
+		delete tree;
+		delete test_world;
+		return false;
+	}
+
+	/* The throwing interface describes the same status */
+	std::string exception_msg = "";
+	try
+	{
+		tree->get_solution();
+	}
+	catch (TerminalException& ex)
+	{
+		exception_msg = ex.what();
+	}
+	if (exception_msg != CBSTree::status_message(SEARCH_EXPANSION_LIMIT))
+	{
+		std::cout << "FAILED: get_solution() does not throw the search status." << std::endl;
+		delete tree;
+		delete test_world;
+		return false;
+	}
+
+	delete tree;
+	delete test_world;
+	return true;
+}
+
+/*
+* Tests for stopping searches by deadline or cancellation
+* @return true if all tests pass or print an error and return false if one test fails
+*/
+bool Tests::cancel_token_tests()
+{
+	/* A token without a deadline only stops once it is cancelled, and stays stopped */
+	CancelToken token;
+	for (int i = 0; i < 2 * CANCEL_CHECK_INTERVAL; i++)
+	{
+		if (token.poll())
+		{
+			std::cout << "FAILED: Token without a deadline expired." << std::endl;
+			return false;
+		}
+	}
+	token.cancel();
+	if (!token.poll() || !token.poll() || !token.is_expired())
+	{
+		std::cout << "FAILED: Cancelled token did not stop the search." << std::endl;
+		return false;
+	}
+
+	/* A passed deadline is noticed by the next full check */
+	CancelToken deadline(1e-9);
+	if (!deadline.check())
+	{
+		std::cout << "FAILED: Token past its deadline did not expire." << std::endl;
+		return false;
+	}
+
+	/* An agent sharing a cancelled token stops without a solution */
+	World* test_world = create_world();
+	Coord start = Coord(0, 0);
+	Coord goal = Coord(2, 0);
+	Agent* search = new Agent(&start, &goal, test_world, "agent_name", &token);
+	if (search->solve() != SEARCH_TIMEOUT)
+	{
+		std::cout << "FAILED: Agent with a cancelled token was solved." << std::endl;
+		delete search;
+		delete test_world;
+		return false;
+	}
+	delete search;
+	delete test_world;
+
+	/* A tree cancelled by its host stops before expanding a node */
+	std::string world_file = create_world_file();
+	std::string agent_file = create_agent_file();
+	CBSTree* tree = new CBSTree(agent_file, world_file);
+	tree->get_cancel_token()->cancel();
+	bool stopped = tree->solve() == NULL && tree->get_status() == SEARCH_TIMEOUT;
+	delete tree;
+	std::remove(world_file.c_str());
+	std::remove(agent_file.c_str());
+	if (!stopped)
+	{
+		std::cout << "FAILED: Cancelled tree did not stop." << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+/*
+* Tests for configuring the solvers at run time
+* @return true if all tests pass or print an error and return false if one test fails
+*/
+bool Tests::solver_options_tests()
+{
+	/* The command line overrides the defaults */
+	char program[] = "main";
+	char classic[] = "--classic";
+	char depth_option[] = "--search-depth";
+	char depth[] = "40";
+	char solver_option[] = "--solver";
+	char solver[] = "ecbs";
+	char* argv[] = { program, classic, depth_option, depth, solver_option, solver };
+	SolverOptions options = SolverOptions();
+	options.parse(6, argv);
+	if (options.repair != REPAIR_NEVER || options.search_depth != 40 || options.solver != SOLVER_ECBS)
+	{
+		std::cout << "FAILED: Command line options were not parsed." << std::endl;
+		return false;
+	}
+
+	/* Unknown options and values out of range are rejected */
+	char bad_depth[] = "0";
+	char* bad_argv[] = { program, depth_option, bad_depth };
+	std::string exception_msg = "";
+	try
+	{
+		options.parse(3, bad_argv);
+	}
+	catch (TerminalException& ex)
+	{
+		exception_msg = ex.what();
+	}
+	if (exception_msg == "")
+	{
+		std::cout << "FAILED: Invalid search depth was accepted." << std::endl;
+		return false;
+	}
+
+	/* Only the cbs solver splits disjointly */
+	char disjoint[] = "--disjoint";
+	char pp[] = "pp";
+	char* pp_argv[] = { program, disjoint, solver_option, pp };
+	exception_msg = "";
+	try
+	{
+		options.parse(4, pp_argv);
+	}
+	catch (TerminalException& ex)
+	{
+		exception_msg = ex.what();
+	}
+	if (exception_msg == "")
+	{
+		std::cout << "FAILED: Disjoint splitting was accepted by prioritized planning." << std::endl;
+		return false;
+	}
+
+	/* FDR-CBS and classic CBS solve the same world in one process */
+	std::string world_file = create_world_file();
+	std::string agent_file = create_agent_file();
+	World* test_world = new World(world_file);
+	SolverOptions fdr = SolverOptions();
+	fdr.repair = REPAIR_ALWAYS;
+	SolverOptions cbs = fdr;
+	cbs.repair = REPAIR_NEVER;
+	CBSTree* fdr_tree = new CBSTree(test_world, agent_file, &fdr);
+	CBSTree* cbs_tree = new CBSTree(test_world, agent_file, &cbs);
+	CBSNode* fdr_solution = fdr_tree->solve();
+	CBSNode* cbs_solution = cbs_tree->solve();
+	bool solved = fdr_solution != NULL && cbs_solution != NULL &&
+		(*fdr_solution->get_agents())[0]->get_options()->repair == REPAIR_ALWAYS &&
+		(*cbs_solution->get_agents())[0]->get_options()->repair == REPAIR_NEVER;
+	delete fdr_solution;
+	delete cbs_solution;
+	delete fdr_tree;
+	delete cbs_tree;
+	delete test_world;
+	std::remove(world_file.c_str());
+	std::remove(agent_file.c_str());
+	if (!solved)
+	{
+		std::cout << "FAILED: Trees with different options did not both solve one world." << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+/*
+* Tests for collapsing the time dimension past the latest constraint
+* @return true if all tests pass or print an error and return false if one test fails
+*/
+bool Tests::collapse_tests()
+{
+	/* Create a world */
+	World* test_world = create_world();
+
+	/* Create the start and goal coordinates */
+	Coord start = Coord(0, 0);
+	Coord goal = Coord(2, 0);
+
+	/* Without constraints waiting again in a reached cell is a duplicate */
+	Agent* search = new Agent(&start, &goal, test_world, "agent_name");
+	search->find_solution();
+	if (search->get_cost() != 2 || search->get_collapse_depth() != 2 ||
+		search->get_open_list_hash_table()->get_size() != 2)
+	{
+		std::cout << "FAILED: Root agent did not collapse repeated cells." << std::endl;
+		delete search;
+		delete test_world;
+		return false;
+	}
+
+	/* Children regenerate the dropped waits their constraints need */
+	Position constraint_1 = Position(1, 0, 1);
+	Agent* child = new Agent(search, &constraint_1);
+	Position constraint_2 = Position(1, 0, 2);
+	Agent* grandchild = new Agent(child, &constraint_2);
+	if (child->get_cost() != 3 || grandchild->get_cost() != 4 || grandchild->get_horizon() != 2)
+	{
+		std::cout << "FAILED: Collapsed children have the wrong cost." << std::endl;
+		delete search;
+		delete child;
+		delete grandchild;
+		delete test_world;
+		return false;
+	}
+
+	delete search;
+	delete child;
+	delete grandchild;
+	delete test_world;
+	return true;
+}
+
+/*
+* Tests for choosing between repairing and searching again a child agent
+* @return true if all tests pass or print an error and return false if one test fails
+*/
+bool Tests::repair_policy_tests()
+{
+	/* Create a world */
+	World* test_world = create_world();
+
+	/* Create the start and goal coordinates */
+	Coord start = Coord(0, 0);
+	Coord goal = Coord(2, 0);
+	Position constraint = Position(1, 0, 1);
+
+	/* A fresh search that costs nothing is always cheaper than a repair */
+	SolverOptions restart = SolverOptions();
+	restart.repair = REPAIR_ADAPTIVE;
+	restart.restart_weight = 0;
+	Agent* search = new Agent(&start, &goal, test_world, "agent_name", NULL, &restart);
+	search->find_solution();
+	Agent::reset_search_counts();
+	Agent* child = new Agent(search, &constraint);
+	if (child->get_cost() != 3 || Agent::get_restart_count() != 1 || Agent::get_repair_count() != 0)
+	{
+		std::cout << "FAILED: Adaptive policy did not restart the child agent." << std::endl;
+		delete search;
+		delete child;
+		delete test_world;
+		return false;
+	}
+	delete search;
+	delete child;
+
+	/* A fresh search that costs more than any copy is never chosen */
+	SolverOptions repair = restart;
+	repair.restart_weight = 1e9;
+	search = new Agent(&start, &goal, test_world, "agent_name", NULL, &repair);
+	search->find_solution();
+	Agent::reset_search_counts();
+	child = new Agent(search, &constraint);
+	if (child->get_cost() != 3 || Agent::get_restart_count() != 0 || Agent::get_repair_count() != 1)
+	{
+		std::cout << "FAILED: Adaptive policy did not repair the child agent." << std::endl;
+		delete search;
+		delete child;
+		delete test_world;
+		return false;
+	}
+
+	delete search;
+	delete child;
+	delete test_world;
+	return true;
+}
+
+/*
+* Tests for removing descendants by following the children bitmaps, serially and in parallel
+* @return true if all tests pass or print an error and return false if one test fails
+*/
+bool Tests::descendant_removal_tests()
+{
+	/* A world with obstacles, so nodes have several parents and children */
+	char test_file[] = "Worlds/test_file.txt";
+	std::ofstream file(test_file);
+	file << "11111\n";
+	file << "10101\n";
+	file << "11111\n";
+	file << "11011\n";
+	file.close();
+	World* test_world = new World(test_file);
+	std::remove(test_file);
+
+	Coord start = Coord(0, 0);
+	Coord goal = Coord(4, 3);
+	SolverOptions fdr = SolverOptions();
+	fdr.repair = REPAIR_ALWAYS;
+	Agent* search = new Agent(&start, &goal, test_world, "agent_name", NULL, &fdr);
+	search->find_solution();
+	std::stack<Coord> path = search->get_solution();
+
+	/* The same search removing every layer with several threads */
+	SolverOptions parallel = fdr;
+	parallel.removal_threads = 4;
+	parallel.parallel_layer_size = 1;
+	Agent* parallel_search = new Agent(&start, &goal, test_world, "agent_name", NULL, &parallel);
+	parallel_search->find_solution();
+
+	/* Each position of the solution is removed by PCA*, by following children and in parallel */
+	bool same = true;
+	unsigned long removed = 0;
+	for (unsigned short depth = 0; !path.empty() && same; depth++)
+	{
+		Position constraint = Position(path.top(), depth);
+		path.pop();
+
+		Agent* pca_star = new Agent(search, NULL);
+		Agent* children = new Agent(search, NULL);
+		Agent* threads = new Agent(parallel_search, NULL);
+		PathClearAStar path_clear(pca_star, &constraint);
+		path_clear.path_clear_a_star();
+		DescendantRemoval removal = DescendantRemoval(children, &constraint);
+		removal.remove_descendants();
+		removed += removal.get_removed();
+		DescendantRemoval parallel_removal = DescendantRemoval(threads, &constraint);
+		parallel_removal.remove_descendants();
+
+		same = same_nodes(pca_star->get_open_list_hash_table(), children->get_open_list_hash_table()) &&
+			same_nodes(pca_star->get_closed_list(), children->get_closed_list()) &&
+			same_nodes(pca_star->get_open_list_hash_table(), threads->get_open_list_hash_table()) &&
+			same_nodes(pca_star->get_closed_list(), threads->get_closed_list()) &&
+			removal.get_removed() == parallel_removal.get_removed();
+		delete pca_star;
+		delete children;
+		delete threads;
+	}
+
+	delete search;
+	delete parallel_search;
+	delete test_world;
+	if (!same || removed == 0)
+	{
+		std::cout << "FAILED: Serial or parallel removal did not remove the nodes PCA* removes." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/*
+* Tests for reusing the lists of PCA* searches
+* @return true if all tests pass or print an error and return false if one test fails
+*/
+bool Tests::path_clear_workspace_tests()
+{
+	/* Every node allocated by the test must be freed by it */
+	unsigned long live_nodes = AStarNode::get_live_count();
+
+	World* test_world = create_world();
+	Coord start = Coord(0, 0);
+	Coord goal = Coord(2, 0);
+	SolverOptions fdr = SolverOptions();
+	fdr.repair = REPAIR_ALWAYS;
+	Agent* search = new Agent(&start, &goal, test_world, "agent_name", NULL, &fdr);
+	search->find_solution();
+
+	/* Consecutive searches of a thread share one workspace */
+	bool reused = true;
+	unsigned int pool_size = 0;
+	for (unsigned short depth = 1; depth <= 2; depth++)
+	{
+		Position constraint = Position(1, 0, depth);
+		Agent* copy = new Agent(search, NULL);
+		{
+			PathClearAStar path_clear(copy, &constraint);
+			path_clear.path_clear_a_star();
+		}
+		if (depth == 1)
+			pool_size = PathClearWorkspace::get_pool_size();
+		else
+			reused = pool_size > 0 && PathClearWorkspace::get_pool_size() == pool_size;
+		delete copy;
+	}
+
+	delete search;
+	delete test_world;
+	if (!reused)
+	{
+		std::cout << "FAILED: PCA* did not give its workspace back to the pool." << std::endl;
+		return false;
+	}
+	if (AStarNode::get_live_count() != live_nodes)
+	{
+		std::cout << "FAILED: PCA* leaked A* Nodes." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/*
+* Tests for the incremental LPA* search, which must find paths as short as a fresh
+* search under the same constraints
+* @return true if all tests pass or print an error and return false if one test fails
+*/
+bool Tests::lpa_star_tests()
+{
+	/* A world with obstacles, so a constraint leaves detours of several lengths */
+	char test_file[] = "Worlds/test_file.txt";
+	std::ofstream file(test_file);
+	file << "11111\n";
+	file << "10101\n";
+	file << "11111\n";
+	file << "11011\n";
+	file.close();
+	World* test_world = new World(test_file);
+	std::remove(test_file);
+
+	Coord start = Coord(0, 0);
+	Coord goal = Coord(4, 3);
+	SolverOptions lpa = SolverOptions();
+	lpa.repair = REPAIR_LPA_STAR;
+	lpa.collapse_states = false;
+	SolverOptions cbs = lpa;
+	cbs.repair = REPAIR_NEVER;
+	unsigned long live = LPAStarSearch::get_live_count();
+
+	Agent* search = new Agent(&start, &goal, test_world, "agent_name", NULL, &lpa);
+	Agent* classic = new Agent(&start, &goal, test_world, "agent_name", NULL, &cbs);
+	bool same = search->get_cost() == classic->get_cost();
+	std::stack<Coord> path = search->get_solution();
+
+	/* Each position of the solution is constrained, then the start at a later depth */
+	for (unsigned short depth = 0; !path.empty() && same; depth++)
+	{
+		Position constraint = Position(path.top(), depth);
+		path.pop();
+
+		Agent* repaired = new Agent(search, &constraint);
+		Agent* restarted = new Agent(classic, &constraint);
+		SearchStatus status = repaired->solve();
+		same = status == restarted->solve() &&
+			(status != SEARCH_SOLVED || repaired->get_cost() == restarted->get_cost());
+
+		/* The later constraint deepens the copied search */
+		Position later = Position(start, 20);
+		if (same && status == SEARCH_SOLVED)
+		{
+			Agent* deeper = new Agent(repaired, &later);
+			Agent* deeper_restarted = new Agent(restarted, &later);
+			same = deeper->get_cost() == deeper_restarted->get_cost();
+
+			/* The repaired path avoids both constraints, a constraint on the start does not apply */
+			std::stack<Coord> deeper_path = deeper->get_solution();
+			deeper_path.pop();
+			for (unsigned short i = 1; !deeper_path.empty(); i++)
+			{
+				Position pos = Position(deeper_path.top(), i);
+				deeper_path.pop();
+				if (pos == constraint || pos == later)
+					same = false;
+			}
+			delete deeper;
+			delete deeper_restarted;
+		}
+		delete repaired;
+		delete restarted;
+	}
+
+	delete search;
+	delete classic;
+	delete test_world;
+	if (!same)
+	{
+		std::cout << "FAILED: LPA* repaired path cost differs from a fresh search." << std::endl;
+		return false;
+	}
+	if (LPAStarSearch::get_live_count() != live)
+	{
+		std::cout << "FAILED: LPA* states were not released with their agents." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/*
+* Tests for resuming a finished search to enumerate the goal arrivals of a cost
+* @return true if all tests pass or print an error and return false if one test fails
+*/
+bool Tests::continued_search_tests()
+{
+	/* Create a world */
+	World* test_world = create_world();
+
+	/* Create the start and goal coordinates */
+	Coord start = Coord(0, 0);
+	Coord goal = Coord(2, 0);
+	SolverOptions fdr = SolverOptions();
+	fdr.repair = REPAIR_ALWAYS;
+	Agent* search = new Agent(&start, &goal, test_world, "agent_name", NULL, &fdr);
+	std::stack<Coord> path = search->get_solution();
+
+	/* One path arrives at the optimal cost, two wait once on the way */
+	std::vector<std::stack<Coord> > paths = std::vector<std::stack<Coord> >();
+	std::vector<std::stack<Coord> > delayed_paths = std::vector<std::stack<Coord> >();
+	std::vector<std::vector<Coord> > layers = std::vector<std::vector<Coord> >();
+	bool correct =
+		search->get_paths(2, 10, &paths) == SEARCH_SOLVED && paths.size() == 1 && paths[0] == path &&
+		search->get_paths(3, 10, &delayed_paths) == SEARCH_SOLVED && delayed_paths.size() == 2 &&
+		search->get_mdd(3, &layers) == SEARCH_SOLVED && layers.size() == 4 &&
+		layers[0].size() == 1 && layers[1].size() == 2 && layers[2].size() == 1 && layers[3].size() == 1 &&
+		search->continue_search(1) == SEARCH_INFEASIBLE && search->get_solution() == path;
+	if (!correct)
+	{
+		std::cout << "FAILED: Continued search did not find every goal arrival." << std::endl;
+		delete search;
+		delete test_world;
+		return false;
+	}
+
+	/* A child copies the continued lists, only waiting at the start avoids its constraint */
+	Position constraint = Position(1, 0, 1);
+	Agent* child = new Agent(search, &constraint);
+	std::vector<std::stack<Coord> > child_paths = std::vector<std::stack<Coord> >();
+	if (child->get_cost() != 3 || child->get_paths(3, 10, &child_paths) != SEARCH_SOLVED ||
+		child_paths.size() != 1)
+	{
+		std::cout << "FAILED: Child of a continued search has the wrong arrivals." << std::endl;
+		delete search;
+		delete child;
+		delete test_world;
+		return false;
+	}
+
+
+	/* An LPA* agent keeps no lists to continue, it reports so instead of throwing */
+	SolverOptions lpa = fdr;
+	lpa.repair = REPAIR_LPA_STAR;
+	Agent* lpa_search = new Agent(&start, &goal, test_world, "agent_name", NULL, &lpa);
+	std::vector<std::stack<Coord> > lpa_paths = std::vector<std::stack<Coord> >();
+	bool unsupported =
+		lpa_search->continue_search(2) == SEARCH_UNSUPPORTED &&
+		lpa_search->get_paths(2, 10, &lpa_paths) == SEARCH_UNSUPPORTED && lpa_paths.empty();
+
+	/* An evicted LPA* agent is not searched again just to report it */
+	lpa_search->get_solution();
+	lpa_search->evict();
+	unsupported = unsupported &&
+		lpa_search->continue_search(2) == SEARCH_UNSUPPORTED && lpa_search->is_evicted();
+
+	delete search;
+	delete child;
+	delete lpa_search;
+	delete test_world;
+	if (!unsupported)
+	{
+		std::cout << "FAILED: Agent without OPEN and CLOSED lists continued its search." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/*
+* Tests for the landmarks and the disjoint splitting of CBSNodes
+* @return true if all tests pass or print an error and return false if one test fails
+*/
+bool Tests::disjoint_splitting_tests()
+{
+	/* Create a world */
+	World* test_world = create_world();
+	SolverOptions fdr = SolverOptions();
+	fdr.repair = REPAIR_ALWAYS;
+
+	/* Held at the start until depth 2, the agent arrives two moves later */
+	Coord start = Coord(0, 0);
+	Coord goal = Coord(2, 0);
+	Position wait = Position(0, 0, 2);
+	Agent* waiting = new Agent(&start, &goal, test_world, "agent_name", NULL, &fdr);
+	waiting->add_landmark(&wait);
+	std::stack<Coord> path = waiting->get_solution();
+	path.pop();
+	path.pop();
+	bool waited = waiting->get_cost() == 4 && path.top() == *wait.get_coord();
+
+	/* A landmark past the goal keeps the agent from leaving when it first gets there */
+	Coord near_goal = Coord(1, 0);
+	Position past_goal = Position(2, 0, 2);
+	Agent* passing = new Agent(&start, &near_goal, test_world, "agent_name", NULL, &fdr);
+	passing->add_landmark(&past_goal);
+	bool passed = passing->get_cost() == 3 && passing->has_landmark(&past_goal);
+
+	/* A landmark out of reach leaves no solution */
+	Position too_far = Position(2, 0, 1);
+	Agent* stuck = new Agent(&start, &goal, test_world, "agent_name", NULL, &fdr);
+	stuck->add_landmark(&too_far);
+	bool infeasible = stuck->solve() == SEARCH_INFEASIBLE;
+
+	delete waiting;
+	delete passing;
+	delete stuck;
+	delete test_world;
+	if (!waited || !passed || !infeasible)
+	{
+		std::cout << "FAILED: Landmarks were not enforced by the A* Search." << std::endl;
+		return false;
+	}
+
+	/* Disjoint splitting finds a conflict free solution of the same cost */
+	std::string world_file = create_world_file();
+	std::string agent_file = create_agent_file();
+	World* tree_world = new World(world_file);
+	SolverOptions disjoint = fdr;
+	disjoint.disjoint_splitting = true;
+	CBSTree* fdr_tree = new CBSTree(tree_world, agent_file, &fdr);
+	CBSTree* disjoint_tree = new CBSTree(tree_world, agent_file, &disjoint);
+	CBSNode* fdr_solution = fdr_tree->solve();
+	CBSNode* disjoint_solution = disjoint_tree->solve();
+	int agent_1, agent_2;
+	Position conflict_1, conflict_2;
+	bool solved = fdr_solution != NULL && disjoint_solution != NULL &&
+		disjoint_solution->get_cost() == fdr_solution->get_cost() &&
+		!disjoint_solution->get_conflicts(&agent_1, &conflict_1, &agent_2, &conflict_2);
+	delete fdr_solution;
+	delete disjoint_solution;
+	delete fdr_tree;
+	delete disjoint_tree;
+	delete tree_world;
+	std::remove(world_file.c_str());
+	std::remove(agent_file.c_str());
+	if (!solved)
+	{
+		std::cout << "FAILED: Disjoint splitting did not find an optimal solution." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/*
+* Tests for the corridors of a World and the ranges of constraints resolving corridor conflicts
+* @return true if all tests pass or print an error and return false if one test fails
+*/
+bool Tests::corridor_reasoning_tests()
+{
+	/* A corridor of length 4 joins two open areas, with no way around it */
+	char world_file[] = "Worlds/test_file.txt";
+	std::ofstream file(world_file);
+	file << "110000011\n";
+	file << "111111111\n";
+	file << "110000011\n";
+	file.close();
+	World* test_world = new World(world_file);
+
+	Coord left = Coord(0, 1);
+	Coord right = Coord(8, 1);
+	Coord inside = Coord(4, 1);
+	Coord open = Coord(1, 1);
+	Coord entrance = Coord(2, 1);
+	Coord exit = Coord(6, 1);
+	std::vector<Coord> corridor = std::vector<Coord>();
+	std::vector<Coord> no_corridor = std::vector<Coord>();
+	bool found =
+		test_world->get_corridor(&inside, &corridor) && corridor.size() == 5 &&
+		corridor.front() == entrance && corridor.back() == exit &&
+		!test_world->get_corridor(&open, &no_corridor) &&
+		test_world->get_distance(&left, &right) == 8 &&
+		test_world->get_distance(&left, &right, &corridor) == -1;
+	if (!found)
+	{
+		std::cout << "FAILED: Corridor of the World was not found." << std::endl;
+		delete test_world;
+		std::remove(world_file);
+		return false;
+	}
+
+	/* Agents crossing the corridor both ways meet inside it */
+	char agent_file[] = "Agents/agent_file.txt";
+	std::ofstream agents_out(agent_file);
+	agents_out << "Agent_1 (0,1) (8,1)\n";
+	agents_out << "Agent_2 (8,1) (0,1)\n";
+	agents_out.close();
+	SolverOptions fdr = SolverOptions();
+	fdr.repair = REPAIR_ALWAYS;
+	SolverOptions corridors = fdr;
+	corridors.corridor_reasoning = true;
+
+	/* Each agent is kept from its exit of the corridor until the other could have crossed */
+	std::vector<Agent*> agents = std::vector<Agent*>();
+	agents.push_back(new Agent(&left, &right, test_world, "Agent_1", NULL, &fdr));
+	agents.push_back(new Agent(&right, &left, test_world, "Agent_2", NULL, &fdr));
+	CBSNode* root = new CBSNode(&agents);
+	int agent_1, agent_2;
+	std::vector<Position> constraints_1 = std::vector<Position>();
+	std::vector<Position> constraints_2 = std::vector<Position>();
+	bool ranged =
+		root->get_conflicts(&agent_1, &constraints_1, &agent_2, &constraints_2, true) &&
+		constraints_1.size() == 10 && constraints_2.size() == 10;
+
+	/* Repairing the copied lists under a whole range finds a path as short as searching again */
+	if (ranged)
+	{
+		SolverOptions cbs = fdr;
+		cbs.repair = REPAIR_NEVER;
+		Agent* classic = new Agent(
+			agents[agent_1]->get_start(), agents[agent_1]->get_goal(), test_world, "Agent_1", NULL, &cbs
+			);
+		Agent* repaired = new Agent(agents[agent_1], &constraints_1[0], constraints_1.size());
+		Agent* restarted = new Agent(classic, &constraints_1[0], constraints_1.size());
+		SearchStatus status = repaired->solve();
+		ranged = status == SEARCH_SOLVED && status == restarted->solve() &&
+			repaired->get_cost() == restarted->get_cost();
+		delete repaired;
+		delete restarted;
+		delete classic;
+	}
+
+	bool single =
+		root->get_conflicts(&agent_1, &constraints_1, &agent_2, &constraints_2, false) &&
+		constraints_1.size() == 1 && constraints_2.size() == 1;
+	delete root;
+	for (unsigned int i = 0; i < agents.size(); i++)
+		delete agents[i];
+	if (!ranged || !single)
+	{
+		std::cout << "FAILED: Corridor conflict was not resolved with ranges of constraints." << std::endl;
+		delete test_world;
+		std::remove(world_file);
+		std::remove(agent_file);
+		return false;
+	}
+
+	/* One agent waits for the other to cross, with or without corridor reasoning */
+	CBSTree* fdr_tree = new CBSTree(test_world, agent_file, &fdr);
+	CBSTree* corridor_tree = new CBSTree(test_world, agent_file, &corridors);
+	CBSNode* fdr_solution = fdr_tree->solve();
+	CBSNode* corridor_solution = corridor_tree->solve();
+	Position conflict_1, conflict_2;
+	bool solved = fdr_solution != NULL && corridor_solution != NULL &&
+		corridor_solution->get_cost() == 13 && fdr_solution->get_cost() == 13 &&
+		!corridor_solution->get_conflicts(&agent_1, &conflict_1, &agent_2, &conflict_2);
+	delete fdr_solution;
+	delete corridor_solution;
+	delete fdr_tree;
+	delete corridor_tree;
+	delete test_world;
+	std::remove(world_file);
+	std::remove(agent_file);
+	if (!solved)
+	{
+		std::cout << "FAILED: Corridor reasoning did not find an optimal solution." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/*
+* Tests for length constraints and target conflicts with agents that stay at their goals
+* @return true if all tests pass or print an error and return false if one test fails
+*/
+bool Tests::target_reasoning_tests()
+{
+	/* A row with a pocket under its second cell */
+	char world_file[] = "Worlds/test_file.txt";
+	std::ofstream file(world_file);
+	file << "1111111\n";
+	file << "0100000\n";
+	file.close();
+	World* test_world = new World(world_file);
+	SolverOptions fdr = SolverOptions();
+	fdr.repair = REPAIR_ALWAYS;
+	fdr.target_reasoning = false;
+	SolverOptions target = fdr;
+	target.target_reasoning = true;
+
+	/* A constraint on the goal only keeps an agent that stays there from finishing early */
+	Coord pocket = Coord(1, 1);
+	Coord goal = Coord(3, 0);
+	Position later = Position(3, 0, 3);
+	Agent* leaving = new Agent(&pocket, &goal, test_world, "agent_name", NULL, &fdr);
+	Agent* staying = new Agent(&pocket, &goal, test_world, "agent_name", NULL, &target);
+	Agent* left = new Agent(leaving, &later);
+	Agent* stayed = new Agent(staying, &later);
+	bool lengths =
+		leaving->get_cost() == 2 && staying->get_cost() == 2 &&
+		left->get_cost() == 2 && left->get_length_depth() == 0 &&
+		stayed->get_cost() == 4 && stayed->get_length_depth() == 4;
+	delete leaving;
+	delete staying;
+	delete left;
+	delete stayed;
+	if (!lengths)
+	{
+		std::cout << "FAILED: Length constraints were not enforced by the A* Search." << std::endl;
+		delete test_world;
+		std::remove(world_file);
+		return false;
+	}
+
+	/* The agent in the pocket finishes on the row before the other agent passes its goal */
+	char agent_file[] = "Agents/agent_file.txt";
+	std::ofstream agents_out(agent_file);
+	agents_out << "Agent_1 (1,1) (3,0)\n";
+	agents_out << "Agent_2 (0,0) (6,0)\n";
+	agents_out.close();
+
+	/* Only a finished agent that stays at its goal is in the way */
+	Coord row_start = Coord(0, 0);
+	Coord row_end = Coord(6, 0);
+	std::vector<Agent*> agents = std::vector<Agent*>();
+	agents.push_back(new Agent(&pocket, &goal, test_world, "Agent_1", NULL, &target));
+	agents.push_back(new Agent(&row_start, &row_end, test_world, "Agent_2", NULL, &target));
+	CBSNode* root = new CBSNode(&agents);
+	int agent_1, agent_2;
+	Position conflict_1, conflict_2;
+	bool found =
+		root->get_conflicts(&agent_1, &conflict_1, &agent_2, &conflict_2) &&
+		conflict_1 == conflict_2 && *conflict_1.get_coord() == goal &&
+		conflict_1.get_depth() == 3;
+	delete root;
+	for (unsigned int i = 0; i < agents.size(); i++)
+		delete agents[i];
+	if (!found)
+	{
+		std::cout << "FAILED: Target conflict was not found." << std::endl;
+		delete test_world;
+		std::remove(world_file);
+		std::remove(agent_file);
+		return false;
+	}
+
+	/* The agent in the pocket waits for the other to pass, at no extra cost */
+	CBSTree* fdr_tree = new CBSTree(test_world, agent_file, &fdr);
+	CBSTree* target_tree = new CBSTree(test_world, agent_file, &target);
+	CBSNode* fdr_solution = fdr_tree->solve();
+	CBSNode* target_solution = target_tree->solve();
+	bool solved = fdr_solution != NULL && target_solution != NULL &&
+		fdr_solution->get_cost() == 6 && target_solution->get_cost() == 6 &&
+		(*fdr_solution->get_agents())[0]->get_cost() == 2 &&
+		(*target_solution->get_agents())[0]->get_cost() == 4 &&
+		!target_solution->get_conflicts(&agent_1, &conflict_1, &agent_2, &conflict_2);
+	delete fdr_solution;
+	delete target_solution;
+	delete fdr_tree;
+	delete target_tree;
+
+	/* Two agents cannot both stay at a shared goal */
+	agents_out.open(agent_file);
+	agents_out << "Agent_1 (1,1) (3,0)\n";
+	agents_out << "Agent_2 (0,0) (3,0)\n";
+	agents_out.close();
+	CBSTree* shared_tree = new CBSTree(test_world, agent_file, &target);
+	CBSNode* shared_solution = shared_tree->solve();
+	bool infeasible = shared_solution == NULL && shared_tree->get_status() == SEARCH_INFEASIBLE;
+	delete shared_solution;
+	delete shared_tree;
+	delete test_world;
+	std::remove(world_file);
+	std::remove(agent_file);
+	if (!solved)
+	{
+		std::cout << "FAILED: Target reasoning did not find an optimal solution." << std::endl;
+		return false;
+	}
+	if (!infeasible)
+	{
+		std::cout << "FAILED: Agents sharing a goal were not infeasible." << std::endl;
+		return false;
+	}
+
+	/* Solvers that let finished agents leave reject target reasoning */
+	SolverOptions lpa = SolverOptions();
+	char program[] = "mapf";
+	char target_flag[] = "--target";
+	char lpa_flag[] = "--lpa";
+	char* argv[] = { program, target_flag, lpa_flag };
+	std::string exception_msg = "";
+	try
+	{
+		lpa.parse(3, argv);
+	}
+	catch (TerminalException& ex)
+	{
+		exception_msg = ex.what();
+	}
+	if (exception_msg == "")
+	{
+		std::cout << "FAILED: Target reasoning was accepted with LPA*." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/*
+* Tests for the occupancy bitsets of the conflict kernel
+* @return true if all tests pass or print an error and return false if one test fails
+*/
+bool Tests::conflict_kernel_tests()
+{
+	/* A world of 80 cells, its bitsets take two words */
+	char world_file[] = "Worlds/test_file.txt";
+	std::ofstream file(world_file);
+	for (int i = 0; i < 8; i++)
+		file << "1111111111\n";
+	file.close();
+	World* test_world = new World(world_file);
+	std::remove(world_file);
+
+	/* Cells on either side of a word and in the last row */
+	Coord first = Coord(0, 0);
+	Coord last_of_word = Coord(3, 6);
+	Coord first_of_word = Coord(4, 6);
+	Coord corner = Coord(9, 7);
+	ConflictKernel kernel = ConflictKernel(test_world, 3);
+	kernel.occupy(&last_of_word, 1);
+	kernel.occupy(&corner, 3);
+	bool occupied =
+		kernel.is_occupied(&last_of_word, 1) && kernel.is_occupied(&corner, 3) &&
+		!kernel.is_occupied(&first_of_word, 1) && !kernel.is_occupied(&last_of_word, 0) &&
+		!kernel.is_occupied(&last_of_word, 2) && !kernel.is_occupied(&corner, 2) &&
+		!kernel.is_occupied(&first, 3);
+	delete test_world;
+	if (!occupied)
+	{
+		std::cout << "FAILED: Conflict kernel did not keep the occupied cells apart." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/*
+* Tests for the pairwise conflicts of the conflict matrix and their refresh in a child
+* @return true if all tests pass or print an error and return false if one test fails
+*/
+bool Tests::conflict_matrix_tests()
+{
+	/* A corridor of five cells */
+	char world_file[] = "Worlds/test_file.txt";
+	std::ofstream file(world_file);
+	file << "11111\n";
+	file.close();
+	World* test_world = new World(world_file);
+	std::remove(world_file);
+
+	/* Agents 0 and 1 meet in the middle, agent 2 keeps to the far end */
+	std::vector<std::vector<Coord> > paths = std::vector<std::vector<Coord> >(3);
+	paths[0].push_back(Coord(0, 0));
+	paths[0].push_back(Coord(1, 0));
+	paths[0].push_back(Coord(2, 0));
+	paths[1].push_back(Coord(2, 0));
+	paths[1].push_back(Coord(1, 0));
+	paths[1].push_back(Coord(0, 0));
+	paths[2].push_back(Coord(4, 0));
+	paths[2].push_back(Coord(3, 0));
+	ConflictMatrix matrix = ConflictMatrix(3);
+	matrix.update(test_world, &paths, false);
+	int agent_1;
+	int agent_2;
+	if (
+		!matrix.get_first_conflict(&agent_1, &agent_2) || agent_1 != 1 || agent_2 != 0 ||
+		matrix.get_depth(0, 1) != 1 || matrix.get_type(1, 0) != CONFLICT_VERTEX ||
+		matrix.get_count(0, 1) != 1 || matrix.get_type(0, 2) != CONFLICT_NONE || matrix.get_total() != 1
+		)
+	{
+		std::cout << "FAILED: Conflict matrix did not find the vertex conflict." << std::endl;
+		delete test_world;
+		return false;
+	}
+
+	/* Agent 1 waits a step and the agents swap cells instead, only its row is checked again */
+	paths[1].clear();
+	paths[1].push_back(Coord(2, 0));
+	paths[1].push_back(Coord(2, 0));
+	paths[1].push_back(Coord(1, 0));
+	paths[1].push_back(Coord(0, 0));
+	ConflictMatrix child = ConflictMatrix(matrix);
+	child.mark_stale(1);
+	child.update(test_world, &paths, false);
+	ConflictMatrix rebuilt = ConflictMatrix(3);
+	rebuilt.update(test_world, &paths, false);
+	bool matches = true;
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < i; j++)
+		{
+			if (
+				child.get_depth(i, j) != rebuilt.get_depth(i, j) ||
+				child.get_type(i, j) != rebuilt.get_type(i, j) ||
+				child.get_count(i, j) != rebuilt.get_count(i, j)
+				)
+				matches = false;
+		}
+	}
+
+	/* Agents swapping cells on their first move conflict, like the ones on later moves */
+	std::vector<std::vector<Coord> > first_paths = std::vector<std::vector<Coord> >(2);
+	first_paths[0].push_back(Coord(0, 0));
+	first_paths[0].push_back(Coord(1, 0));
+	first_paths[1].push_back(Coord(1, 0));
+	first_paths[1].push_back(Coord(0, 0));
+	ConflictMatrix first_move = ConflictMatrix(2);
+	first_move.update(test_world, &first_paths, false);
+	bool swapped =
+		first_move.get_first_conflict(&agent_1, &agent_2) && first_move.get_depth(0, 1) == 1 &&
+		first_move.get_type(0, 1) == CONFLICT_SWAP && first_move.get_total() == 1;
+	delete test_world;
+	if (!swapped)
+	{
+		std::cout << "FAILED: Conflict matrix missed agents swapping on their first move." << std::endl;
+		return false;
+	}
+	if (
+		!matches || child.get_total() != rebuilt.get_total() ||
+		child.get_depth(0, 1) != 2 || child.get_type(0, 1) != CONFLICT_SWAP
+		)
+	{
+		std::cout << "FAILED: Conflict matrix of the child does not match a full check." << std::endl;
+		return false;
+	}
+
+	/* The parent's matrix is left unchanged */
+	if (matrix.get_type(0, 1) != CONFLICT_VERTEX)
+	{
+		std::cout << "FAILED: Conflict matrix of the parent changed with its child." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/*
+* Tests for the bounded suboptimal ECBSTree
+* @return true if all tests pass or print an error and return false if one test fails
+*/
+bool Tests::ecbs_tree_tests()
+{
+	/* Create the world and agent files */
+	std::string world_file = create_world_file();
+	std::string agent_file = create_agent_file();
+
+	/* Find a solution at most 1.5 times the optimal cost */
+	const double WEIGHT = 1.5;
+	ECBSTree* tree = new ECBSTree(agent_file, world_file, WEIGHT);
+	CBSNode* solution_node = tree->get_solution();
+
+	/* The solution must be conflict free */
+	int agent_1, agent_2;
+	Position conflict_1, conflict_2;
+	if (solution_node->get_conflicts(&agent_1, &conflict_1, &agent_2, &conflict_2))
+	{
+		std::cout << "FAILED: ECBSTree solution has a conflict." << std::endl;
+		delete solution_node;
+		delete tree;
+		return false;
+	}
+
+	/* The solution must be within the bound of the optimal cost (2) */
+	if (
+		solution_node->get_cost() > WEIGHT * 2 || tree->get_lower_bound() > 2 ||
+		tree->get_achieved_bound() > WEIGHT
+		)
+	{
+		std::cout << "FAILED: ECBSTree solution exceeds the suboptimality bound." << std::endl;
+		delete solution_node;
+		delete tree;
+		return false;
+	}
+
+	delete solution_node;
+	delete tree;
+	return true;
+}
+
+/*
+* Tests for the anytime LNSTree
+* @return true if all tests pass or print an error and return false if one test fails
+*/
+bool Tests::lns_tree_tests()
+{
+	/* Create the world and agent files */
+	std::string world_file = create_world_file();
+	std::string agent_file = create_agent_file();
+
+	/* Improve the prioritized plan for a few neighborhoods */
+	LNSTree* tree = new LNSTree(agent_file, world_file);
+	tree->set_max_iterations(20);
+	CBSNode* solution_node = tree->get_solution();
+
+	/* The plan must be conflict free */
+	int agent_1, agent_2;
+	Position conflict_1, conflict_2;
+	if (solution_node->get_conflicts(&agent_1, &conflict_1, &agent_2, &conflict_2))
+	{
+		std::cout << "FAILED: LNSTree plan has a conflict." << std::endl;
+		delete solution_node;
+		delete tree;
+		return false;
+	}
+
+	/* The lower bound is the longest shortest path (2) and the plan can not beat it */
+	if (
+		tree->get_lower_bound() != 2 || solution_node->get_cost() != tree->get_cost() ||
+		tree->get_cost() < tree->get_lower_bound()
+		)
+	{
+		std::cout << "FAILED: LNSTree cost or lower bound is not correct." << std::endl;
+		delete solution_node;
+		delete tree;
+		return false;
+	}
+
+	delete solution_node;
+	delete tree;
+	return true;
+}
+
+/*
+* Tests for the PrioritizedPlanner, standalone and as a warm start for CBS
+* @return true if all tests pass or print an error and return false if one test fails
+*/
+bool Tests::prioritized_planner_tests()
+{
+	/* Create the world and agent files */
+	std::string world_file = create_world_file();
+	std::string agent_file = create_agent_file();
+
+	/* Plan the farthest agents first, each staying at its goal */
+	PrioritizedTree* pp_tree = new PrioritizedTree(agent_file, world_file);
+	pp_tree->get_planner()->order_by_distance(true);
+	pp_tree->get_planner()->set_park_at_goal(true);
+	CBSNode* solution_node = pp_tree->get_solution();
+
+	/* No agent may meet, swap with or pass a parked agent in the order planned */
+	std::vector<int> order = *pp_tree->get_planner()->get_order();
+	ReservationTable reserved = ReservationTable();
+	int num_agents = order.size();
+	for (int i = 0; i < num_agents; i++)
+	{
+		std::stack<Coord> path = (*solution_node->get_agents())[order[i]]->get_solution();
+		if (reserved.count_path_conflicts(path) != 0)
+		{
+			std::cout << "FAILED: Prioritized plan has a conflict." << std::endl;
+			delete solution_node;
+			delete pp_tree;
+			return false;
+		}
+		reserved.add_path(path, true);
+	}
+	delete solution_node;
+	delete pp_tree;
+
+	/* A warm started CBSTree finds the same cost as one without an upper bound */
+	CBSTree* tree = new CBSTree(agent_file, world_file);
+	solution_node = tree->get_solution();
+	int cost = solution_node->get_cost();
+	delete solution_node;
+	delete tree;
+
+	tree = new CBSTree(agent_file, world_file);
+	if (!tree->warm_start() || tree->get_upper_bound() < cost)
+	{
+		std::cout << "FAILED: Warm start upper bound is not correct." << std::endl;
+		delete tree;
+		return false;
+	}
+	solution_node = tree->get_solution();
+	if (solution_node->get_cost() != cost)
+	{
+		std::cout << "FAILED: Warm started CBSTree solution has a different cost." << std::endl;
+		delete solution_node;
+		delete tree;
+		return false;
+	}
+	delete solution_node;
+	delete tree;
+
+	/* Planned first, Agent_1 crosses the start of Agent_2 before it can leave */
+	char line_world[] = "Worlds/test_file.txt";
+	std::ofstream file(line_world);
+	file << "111\n";
+	file.close();
+	char line_agents[] = "Agents/agent_file.txt";
+	std::ofstream agents_out(line_agents);
+	agents_out << "Agent_1 (0,0) (2,0)\n";
+	agents_out << "Agent_2 (2,0) (1,0)\n";
+	agents_out.close();
+
+	/* The fixed order fails without claiming that no solution exists */
+	pp_tree = new PrioritizedTree(line_agents, line_world);
+	PrioritizedPlanner* planner = pp_tree->get_planner();
+	bool failed = !planner->plan() && planner->get_status() == SEARCH_PRIORITY_FAILED &&
+		planner->get_planned() == 1;
+	if (!failed)
+	{
+		std::cout << "FAILED: Prioritized planning did not fail in the given order." << std::endl;
+		delete pp_tree;
+		std::remove(line_world);
+		std::remove(line_agents);
+		return false;
+	}
+
+	/* Planning Agent_2 first lets Agent_1 wait for it */
+	solution_node = pp_tree->solve();
+	if (solution_node == NULL || solution_node->get_cost() != 3 || (*planner->get_order())[0] != 1)
+	{
+		std::cout << "FAILED: Prioritized planning did not retry another order." << std::endl;
+		if (solution_node != NULL)
+			delete solution_node;
+		delete pp_tree;
+		std::remove(line_world);
+		std::remove(line_agents);
+		return false;
+	}
+
+	delete solution_node;
+	delete pp_tree;
+	std::remove(line_world);
+	std::remove(line_agents);
+	return true;
+}
+
+/*
+* Create a 3x3 world with no obstacles
+* @return a string file name for the newly created world file
+*/
+std::string Tests::create_world_file()
+{
+	/* Name of the world file */
+	char test_file[] = "Worlds/test_file.txt";
+
+	/* Create the world */
+	std::ofstream file(test_file);
+	file << "111\n";
+	file << "111\n";
+	file << "111\n";
+	file.close();
+
+	return std::string(test_file);
+}
+
+/*
+* Create a file containing several agents 
+* @return a string file name for the newly created agent file
+*/
+std::string Tests::create_agent_file()
+{
+	/* Name of the agent file */
+	char test_file[] = "Agents/agent_file.txt";
+
+	/* Create 3 agents */
+	std::ofstream file(test_file);
+	file << "Agent_1 (0,0) (2,2)\n";
+	file << "Agent_2 (1,0) (1,2)\n";
+	file << "Agent_3 (2,2) (0,1)\n";
+	file.close();
+
+	return std::string(test_file);
+}
+
+/*
+* Check that two lists hold the same positions with the same parents
+* @param list_1: The first list
+* @param list_2: The second list
+* @return true if the lists match, false otherwise
+*/
+bool Tests::same_nodes(AStarNodeList* list_1, AStarNodeList* list_2)
+{
+	if (list_1->get_size() != list_2->get_size())
+		return false;
+
+	std::unordered_multimap<unsigned int, AStarNode*>* map = list_1->get_list()->get_map();
+	for (auto it = map->begin(); it != map->end(); it++)
+	{
+		AStarNode* match = list_2->check_duplicate(it->second->get_pos());
+		if (match == NULL || match->get_parent_bitmap() != it->second->get_parent_bitmap())
+			return false;
+	}
+	return true;
 }
 
 /* 
@@ -8,6 +8,7 @@ class Coord;
 class World;
 class Agent;
 class CBSNode;
+class AStarNodeList;
 
 class Tests
 {
@@ -23,8 +24,28 @@ public:
 	static bool world_tests();
 	static bool a_star_tests();
 	static bool path_clear_a_star_tests();
+	static bool eviction_tests();
+	static bool sipp_tests();
+	static bool reachability_tests();
+	static bool status_tests();
+	static bool cancel_token_tests();
+	static bool solver_options_tests();
+	static bool repair_policy_tests();
+	static bool descendant_removal_tests();
+	static bool path_clear_workspace_tests();
+	static bool lpa_star_tests();
+	static bool continued_search_tests();
+	static bool disjoint_splitting_tests();
+	static bool corridor_reasoning_tests();
+	static bool target_reasoning_tests();
+	static bool conflict_kernel_tests();
+	static bool conflict_matrix_tests();
+	static bool collapse_tests();
 	static bool cbs_node_tests();
 	static bool cbs_tree_tests();
+	static bool ecbs_tree_tests();
+	static bool lns_tree_tests();
+	static bool prioritized_planner_tests();
 	
 	/* Non-automated tests */
 	static void print_world_test(std::string test_file);
@@ -34,6 +55,7 @@ public:
 	static World* create_world();
 	static std::string create_world_file();
 	static std::string create_agent_file();
+	static bool same_nodes(AStarNodeList* list_1, AStarNodeList* list_2);
 	static bool check_top_coord(std::stack<Coord>& path, Coord* check_coord);
 	static void cbs_node_cleanup(Agent* a_1, Agent* a_2, CBSNode* node);
 	static void cbs_tree_cleanup(Coord* c0, Coord* c1, Coord* c2);
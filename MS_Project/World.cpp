@@ -1,5 +1,9 @@
 #include <fstream>
 #include <iostream>
+#include <queue>
+#include <stack>
+#include <algorithm>
+#include <climits>
 
 #include "World.h"
 #include "Coordinates.h"
@@ -11,6 +15,9 @@ World::World()
 	coords = std::vector<bool>();
 	max_x = 0;
 	max_y = 0;
+	components = std::vector<int>();
+	component_sizes = std::vector<int>();
+	articulation_points = std::vector<bool>();
 }
 
 /*
@@ -103,6 +110,10 @@ World::World(std::string txt_file)
 			coords.push_back(false);
 	}
 	world_file.close();
+
+	/* Reachability does not change once the World is loaded */
+	find_components();
+	find_articulation_points();
 }
 
 /* 
@@ -152,4 +163,318 @@ void World::print_world()
 		x_coord++;
 	}
 	std::cout << std::endl;
-}
\ No newline at end of file
+}
+/*
+* Check if a path exists between two coordinates, ignoring other agents
+* @param coord_1: The first coordinate
+* @param coord_2: The second coordinate
+* @return true if both coordinates are open and in the same connected component
+*/
+bool World::connected(Coord* coord_1, Coord* coord_2)
+{
+	int component = get_component(coord_1);
+	return component != -1 && component == get_component(coord_2);
+}
+
+/*
+* Check if removing an open coordinate disconnects its connected component
+* @param coord: The coordinate to check
+* @return true if the coordinate is an articulation point, false otherwise
+*/
+bool World::is_articulation_point(Coord* coord)
+{
+	int index = get_index(coord);
+	return index != -1 && articulation_points[index];
+}
+
+/*
+* Get the connected component of a coordinate
+* @param coord: The coordinate to check
+* @return the number of the component, -1 if the coordinate is blocked or does not exist
+*/
+int World::get_component(Coord* coord)
+{
+	int index = get_index(coord);
+	if (index == -1)
+		return -1;
+	return components[index];
+}
+
+/*
+* Get the number of open coordinates in the connected component of a coordinate
+* @param coord: The coordinate to check
+* @return the size of the component, 0 if the coordinate is blocked or does not exist
+*/
+int World::get_component_size(Coord* coord)
+{
+	int component = get_component(coord);
+	if (component == -1)
+		return 0;
+	return component_sizes[component];
+}
+
+/*
+* Get the 1 wide corridor through a coordinate. A corridor cell has exactly two open
+* neighbors, the cells before and after it, so agents inside it can only move along
+* it. The corridor ends at the first cell on either side that is not a corridor cell.
+* @param coord: The coordinate to check
+* @param corridor: Filled with the cells of the corridor, from one endpoint to the other
+* @return true if the coordinate is a corridor cell between two different endpoints
+*/
+bool World::get_corridor(Coord* coord, std::vector<Coord>* corridor)
+{
+	int index = get_index(coord);
+	if (index == -1 || !coords[index])
+		return false;
+	std::vector<int> neighbors;
+	get_neighbors(index, &neighbors);
+	if (neighbors.size() != 2)
+		return false;
+
+	/* Walk away from the coordinate on both sides, a ring of corridor cells has no ends */
+	std::vector<int> side_1, side_2;
+	if (walk_corridor(index, neighbors[0], index, &side_1) == -1 ||
+		walk_corridor(index, neighbors[1], index, &side_2) == -1 ||
+		side_1.back() == side_2.back())
+		return false;
+
+	corridor->clear();
+	for (int i = side_1.size() - 1; i >= 0; i--)
+		corridor->push_back(Coord(side_1[i] % (max_x + 1), side_1[i] / (max_x + 1)));
+	corridor->push_back(Coord(coord));
+	for (unsigned int i = 0; i < side_2.size(); i++)
+		corridor->push_back(Coord(side_2[i] % (max_x + 1), side_2[i] / (max_x + 1)));
+	return true;
+}
+
+/*
+* Follow a corridor from one of its cells until a cell that is not in a corridor
+* @param prev: The index of the cell the walk comes from
+* @param index: The index of the first cell of the walk
+* @param start: The index of the cell the corridor was entered at, to detect a ring
+* @param cells: The indices of the cells walked, the endpoint last
+* @return the index of the endpoint, -1 if the walk came back to start
+*/
+int World::walk_corridor(int prev, int index, int start, std::vector<int>* cells)
+{
+	std::vector<int> neighbors;
+	while (true)
+	{
+		if (index == start)
+			return -1;
+		cells->push_back(index);
+
+		neighbors.clear();
+		get_neighbors(index, &neighbors);
+		if (neighbors.size() != 2)
+			return index;
+
+		/* Continue to the neighbor the walk did not come from */
+		int next = neighbors[0] == prev ? neighbors[1] : neighbors[0];
+		prev = index;
+		index = next;
+	}
+}
+
+/*
+* Get the fewest moves between two coordinates with a breadth first search
+* @param from: The coordinate to start at
+* @param to: The coordinate to reach
+* @param avoid: Coordinates that cannot be entered, NULL if there are none
+* @return the number of moves, -1 if the coordinate cannot be reached
+*/
+int World::get_distance(Coord* from, Coord* to, std::vector<Coord>* avoid)
+{
+	int from_index = get_index(from);
+	int to_index = get_index(to);
+	if (from_index == -1 || to_index == -1 || !coords[from_index] || !coords[to_index])
+		return -1;
+
+	/* Avoided coordinates count as reached so they are never entered */
+	std::vector<int> distances = std::vector<int>(coords.size(), -1);
+	if (avoid != NULL)
+	{
+		for (unsigned int i = 0; i < avoid->size(); i++)
+		{
+			int index = get_index(&(*avoid)[i]);
+			if (index != -1)
+				distances[index] = INT_MAX;
+		}
+	}
+	if (distances[from_index] != -1 || distances[to_index] != -1)
+		return -1;
+
+	distances[from_index] = 0;
+	std::queue<int> frontier;
+	frontier.push(from_index);
+	std::vector<int> neighbors;
+	while (!frontier.empty())
+	{
+		int index = frontier.front();
+		frontier.pop();
+		if (index == to_index)
+			return distances[index];
+
+		neighbors.clear();
+		get_neighbors(index, &neighbors);
+		for (unsigned int i = 0; i < neighbors.size(); i++)
+		{
+			if (distances[neighbors[i]] == -1)
+			{
+				distances[neighbors[i]] = distances[index] + 1;
+				frontier.push(neighbors[i]);
+			}
+		}
+	}
+	return -1;
+}
+
+/*
+* Get the index of a coordinate in coords
+* @param coord: The coordinate to find
+* @return the index of the coordinate, -1 if it does not exist
+*/
+int World::get_index(Coord* coord)
+{
+	unsigned short x_coord = coord->get_xcoord();
+	unsigned short y_coord = coord->get_ycoord();
+	if (x_coord > max_x || y_coord > max_y || components.empty())
+		return -1;
+	return y_coord * (max_x + 1) + x_coord;
+}
+
+/*
+* Get the indices of the open coordinates an agent can move to from an index.
+* Agents move in 8 directions, so diagonal neighbors are adjacent.
+* @param index: The index of the coordinate
+* @param neighbors: Vector the indices of the open neighbors are appended to
+*/
+void World::get_neighbors(int index, std::vector<int>* neighbors)
+{
+	int x_coord = index % (max_x + 1);
+	int y_coord = index / (max_x + 1);
+	for (int y = y_coord - 1; y <= y_coord + 1; y++)
+	{
+		for (int x = x_coord - 1; x <= x_coord + 1; x++)
+		{
+			if ((x == x_coord && y == y_coord) || x < 0 || y < 0 || x > max_x || y > max_y)
+				continue;
+			int neighbor = y * (max_x + 1) + x;
+			if (coords[neighbor])
+				neighbors->push_back(neighbor);
+		}
+	}
+}
+
+/*
+* Label the connected components of the open coordinates with a breadth first search
+*/
+void World::find_components()
+{
+	components = std::vector<int>(coords.size(), -1);
+	component_sizes = std::vector<int>();
+
+	std::vector<int> neighbors;
+	for (int start = 0; start < static_cast<int>(coords.size()); start++)
+	{
+		/* Start a new component from each open coordinate not yet labelled */
+		if (!coords[start] || components[start] != -1)
+			continue;
+
+		int component = component_sizes.size();
+		component_sizes.push_back(0);
+		components[start] = component;
+
+		std::queue<int> frontier;
+		frontier.push(start);
+		while (!frontier.empty())
+		{
+			int index = frontier.front();
+			frontier.pop();
+			component_sizes[component]++;
+
+			neighbors.clear();
+			get_neighbors(index, &neighbors);
+			for (unsigned int i = 0; i < neighbors.size(); i++)
+			{
+				if (components[neighbors[i]] == -1)
+				{
+					components[neighbors[i]] = component;
+					frontier.push(neighbors[i]);
+				}
+			}
+		}
+	}
+}
+
+/*
+* Find the articulation points of each connected component with Tarjan's
+* depth first search, kept iterative so large open areas do not overflow the stack
+*/
+void World::find_articulation_points()
+{
+	int size = coords.size();
+	articulation_points = std::vector<bool>(size, false);
+
+	/* Discovery order and lowest discovery order reachable from each subtree */
+	std::vector<int> discovery(size, -1);
+	std::vector<int> low(size, 0);
+	std::vector<int> parent(size, -1);
+	int order = 0;
+
+	for (int root = 0; root < size; root++)
+	{
+		if (!coords[root] || discovery[root] != -1)
+			continue;
+
+		/* Each entry is a coordinate and the next of its neighbors to visit */
+		std::stack<std::pair<int, int> > path;
+		std::vector<std::vector<int> > neighbors_of(1);
+		discovery[root] = low[root] = order++;
+		get_neighbors(root, &neighbors_of[0]);
+		path.push(std::pair<int, int>(root, 0));
+		int root_children = 0;
+
+		while (!path.empty())
+		{
+			int index = path.top().first;
+			int next = path.top().second;
+			std::vector<int>* neighbors = &neighbors_of[path.size() - 1];
+
+			/* Descend into the next unvisited neighbor */
+			if (next < static_cast<int>(neighbors->size()))
+			{
+				path.top().second++;
+				int neighbor = (*neighbors)[next];
+				if (discovery[neighbor] == -1)
+				{
+					parent[neighbor] = index;
+					discovery[neighbor] = low[neighbor] = order++;
+					if (index == root)
+						root_children++;
+
+					if (neighbors_of.size() <= path.size())
+						neighbors_of.push_back(std::vector<int>());
+					neighbors_of[path.size()].clear();
+					get_neighbors(neighbor, &neighbors_of[path.size()]);
+					path.push(std::pair<int, int>(neighbor, 0));
+				}
+				else if (neighbor != parent[index])
+					low[index] = std::min(low[index], discovery[neighbor]);
+				continue;
+			}
+
+			/* Every neighbor is visited, report back to the parent */
+			path.pop();
+			int up = parent[index];
+			if (up == -1)
+				continue;
+			low[up] = std::min(low[up], low[index]);
+			if (up != root && low[index] >= discovery[up])
+				articulation_points[up] = true;
+		}
+
+		/* The root separates its component only if it has several subtrees */
+		articulation_points[root] = root_children > 1;
+	}
+}
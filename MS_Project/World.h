@@ -16,6 +16,24 @@ public:
 	bool check_coord(Coord* coord);
 	/* Print the World to the console */
 	void print_world();
+	/* Check if a path exists between two coordinates, ignoring other agents */
+	bool connected(Coord* coord_1, Coord* coord_2);
+	/* Check if removing an open coordinate disconnects its connected component */
+	bool is_articulation_point(Coord* coord);
+	/* Connected component of a coordinate, -1 if it is blocked or does not exist */
+	int get_component(Coord* coord);
+	/* Number of open coordinates in the connected component of a coordinate */
+	int get_component_size(Coord* coord);
+	/* Get the 1 wide corridor through a coordinate, from one endpoint to the other */
+	bool get_corridor(Coord* coord, std::vector<Coord>* corridor);
+	/* Fewest moves between two coordinates, optionally avoiding some coordinates */
+	int get_distance(Coord* from, Coord* to, std::vector<Coord>* avoid = NULL);
+
+	/* Accessors */
+	unsigned short get_max_x() const { return max_x; };
+	unsigned short get_max_y() const { return max_y; };
+	/* Number of coordinates in the World, open or blocked */
+	int get_size() const { return coords.size(); };
 private:
 	/* Boolean vector where true means the space is open, false if it is blocked */
 	std::vector<bool> coords;
@@ -23,6 +41,23 @@ private:
 	unsigned short max_x;
 	/* Maximum Y coordinate of the matrix(starts at 0) */
 	unsigned short max_y;
+	/* Connected component of each coordinate, -1 if the coordinate is blocked */
+	std::vector<int> components;
+	/* Number of open coordinates in each connected component */
+	std::vector<int> component_sizes;
+	/* True for each open coordinate whose removal disconnects its component */
+	std::vector<bool> articulation_points;
+
+	/* Index of a coordinate in coords, -1 if it does not exist */
+	int get_index(Coord* coord);
+	/* Get the indices of the open coordinates an agent can move to from an index */
+	void get_neighbors(int index, std::vector<int>* neighbors);
+	/* Follow a corridor from one of its cells until a cell that is not in a corridor */
+	int walk_corridor(int prev, int index, int start, std::vector<int>* cells);
+	/* Label the connected components of the open coordinates */
+	void find_components();
+	/* Find the articulation points of each connected component */
+	void find_articulation_points();
 };
 
 #endif
\ No newline at end of file
@@ -9,22 +9,46 @@
 #include "Macros.h"
 #include "Utils.h"
 #include "CBSNode.h"
+#include "ECBSTree.h"
+#include "LNSTree.h"
+#include "PrioritizedTree.h"
+#include "SearchStatus.h"
+#include "SolverOptions.h"
+#include "World.h"
 
 
 void catch_failure(
-	int& failures, int &depth_exceeded, std::string exception_msg, 
+	int& failures, int &depth_exceeded, SearchStatus status, 
 	std::ofstream* output_file, int test_num
 	);
 double test_stats(
 	std::vector<double>* test_times, std::ofstream* output_file, int test_num
 	);
+CBSTree* create_tree(
+	World* world, std::string agent_file, std::string world_file, SolverOptions* options
+	);
+void print_peak_memory(CBSTree* tree, std::ostream* out);
+void print_bound(CBSTree* tree, SolverOptions* options, std::ostream* out);
+void run_benchmark(SolverOptions* options);
 
 #ifdef NUM_GEN_TESTS
 #include "TestGenerator.h"
 #endif
 
-int main()
+int main(int argc, char** argv)
 {
+	/* Solver configuration, the command line overrides the defaults of Macros.h */
+	SolverOptions options = SolverOptions();
+	try
+	{
+		options.parse(argc, argv);
+	}
+	catch (TerminalException& ex)
+	{
+		std::cout << ex.what() << std::endl << SolverOptions::usage();
+		return 1;
+	}
+
 #ifdef NUM_GEN_TESTS
 	/* Number of probability of an element being an obstacle */
 	const double OBS_PROB = 0.35;
@@ -53,24 +77,29 @@ int main()
 	/* Create the CBSTree and output its solution to an output file */
 	try
 	{
-		tree = new CBSTree(agent_file, world_file);
-		tree->file_print_solution();
-		delete tree;
-	}
-	catch (TerminalException& ex)
-	{
-		/* Get the exception message */
-		std::string exception_msg = ex.what();
+		tree = create_tree(NULL, agent_file, world_file, &options);
+		SearchStatus status = tree->file_print_solution();
 
-		/* Special Case: Time limit exceeded exception */
-		if (exception_msg == "TIME LIMIT EXCEEDED")
+		/* Special Case: Time limit exceeded */
+		if (status == SEARCH_TIMEOUT)
 		{
 			std::cout << "Test failed." << std::endl;
 			std::cin.get();
 		}
-		/* Print the error message */
+		/* Print why the search stopped */
+		else if (status != SEARCH_SOLVED)
+			std::cout << CBSTree::status_message(status) << std::endl;
 		else
-			std::cout << exception_msg << std::endl;
+		{
+			print_peak_memory(tree, &std::cout);
+			print_bound(tree, &options, &std::cout);
+		}
+		delete tree;
+	}
+	catch (TerminalException& ex)
+	{
+		/* Only malformed input files throw */
+		std::cout << ex.what() << std::endl;
 	}
 #endif
 
@@ -78,7 +107,40 @@ int main()
 	Tests::run_tests();
 #endif
 
-#ifdef NUM_TESTS
+	/* Time the test files */
+	if (options.num_tests > 0)
+		run_benchmark(&options);
+
+	return 0;
+}
+
+/*
+* Time every test file with the configured solver, or with FDR-CBS, classic CBS,
+* adaptive repair and LPA-CBS when comparing them. Each world is loaded once and searched by
+* every solver compared.
+* @param options: The solver configuration and the number of tests and runs
+*/
+void run_benchmark(SolverOptions* options)
+{
+	/* Solvers timed, configurations that differ only in how agents are repaired */
+	std::vector<SolverOptions> variants = std::vector<SolverOptions>();
+	variants.push_back(*options);
+	if (options->compare)
+	{
+		variants[0].repair = REPAIR_ALWAYS;
+		variants.push_back(*options);
+		variants[1].repair = REPAIR_NEVER;
+		variants.push_back(*options);
+		variants[2].repair = REPAIR_ADAPTIVE;
+		variants.push_back(*options);
+		variants[3].repair = REPAIR_LPA_STAR;
+
+		/* LPA* does not enforce the landmarks of disjoint splitting or length constraints */
+		variants[3].disjoint_splitting = false;
+		variants[3].target_reasoning = false;
+	}
+	int num_variants = variants.size();
+
 	/* Start time of the test */
 	std::clock_t start;
 	std::clock_t pca_start;
@@ -86,14 +148,10 @@ int main()
 	/* Tree variable */
 	CBSTree* tree = NULL;
 
-	/* Variable storing the sum of all test times */
-	double sum_time = 0;
-
-	/* Failure count */
-	int failures = 0;
-
-	/* Search depth exceeded count */
-	int depth_exceeded = 0;
+	/* Sum of all test times, failure count and search depth exceeded count of each solver */
+	std::vector<double> sum_time = std::vector<double>(num_variants, 0);
+	std::vector<int> failures = std::vector<int>(num_variants, 0);
+	std::vector<int> depth_exceeded = std::vector<int>(num_variants, 0);
 
 	/* Test file name prefixes and suffixes */
 	std::string world_file_prefix = "TestWorlds/test_file";
@@ -110,7 +168,7 @@ int main()
 	bool test_failed = false;
 
 	/* Loop through each test */
-	for (int i = 0; i < NUM_TESTS; i++)
+	for (int i = 0; i < options->num_tests; i++)
 	{
 		/* Create the world and agent file */
 		std::string world_file = world_file_prefix + Utils::to_string(i) + suffix;
@@ -119,85 +177,123 @@ int main()
 		/* Print the test number to the console */
 		std::cout << "Currently running test number " << i << "." << std::endl;
 
-		/* No test failed yet since none were run */
-		test_failed = false;
-
-		/* Vector containing each test time */
-		std::vector<double> test_times;
+		/* Load the world once for every solver */
+		World* world;
+		try
+		{
+			world = new World(world_file);
+		}
+		catch (TerminalException& ex)
+		{
+			std::cout << ex.what() << std::endl;
+			continue;
+		}
 
-		for (int j = 0; j < TEST_RUN_COUNT; j++)
+		for (int v = 0; v < num_variants; v++)
 		{
-			/* Don't run again if one test failed */
-			if (test_failed == true)
-				break;
+			/* Label the results of each solver when comparing */
+			if (num_variants > 1)
+				output_file << variants[v].get_name() << ": ";
 
-			/* Start the timer */
-			start = std::clock();
+			/* No test failed yet since none were run */
+			test_failed = false;
 
-			/* Create the CBSTree and find the solution */
-			try
+			/* Vector containing each test time */
+			std::vector<double> test_times;
+
+			for (int j = 0; j < variants[v].test_run_count; j++)
 			{
-				tree = new CBSTree(agent_file, world_file);
+				/* Don't run again if one test failed */
+				if (test_failed == true)
+					break;
+
+				/* Start the timer */
+				start = std::clock();
+
+				/* Create the CBSTree and find the solution */
+				try
+				{
+					tree = create_tree(world, agent_file, world_file, &variants[v]);
 
 #ifdef CONFLICT_CORRECTION_TIME
-				pca_start = std::clock();
+					pca_start = std::clock();
 #endif
 
-				CBSNode* sol = tree->get_solution();
-				cost = sol->get_cost();
-				delete sol;
-				delete tree;
-			}
-			catch (TerminalException& ex)
-			{
-				catch_failure(failures, depth_exceeded, ex.what(), &output_file, i);
-				test_failed = true;
-				continue;
-			}
-
-			/* Store the test time */
+					CBSNode* sol = tree->solve();
+					if (sol == NULL)
+					{
+						catch_failure(
+							failures[v], depth_exceeded[v], tree->get_status(), &output_file, i
+							);
+						delete tree;
+						test_failed = true;
+						continue;
+					}
+					cost = sol->get_cost();
+					delete sol;
+
+					/* Report the memory high-water mark of this run */
+					output_file << "Test " << i << " run " << j << " ";
+					print_peak_memory(tree, &output_file);
+					print_bound(tree, &variants[v], &output_file);
+					delete tree;
+				}
+				catch (TerminalException& ex)
+				{
+					/* Only malformed input files throw */
+					std::cout << ex.what() << std::endl;
+					test_failed = true;
+					continue;
+				}
+
+				/* Store the test time */
 #ifdef CONFLICT_CORRECTION_TIME
-			test_times.push_back(double(std::clock() - pca_start) / CLOCKS_PER_SEC);
+				test_times.push_back(double(std::clock() - pca_start) / CLOCKS_PER_SEC);
 #else
-			test_times.push_back(double(std::clock() - start) / CLOCKS_PER_SEC);
+				test_times.push_back(double(std::clock() - start) / CLOCKS_PER_SEC);
 #endif
+			}
+			if (test_failed == false)
+				sum_time[v] += test_stats(&test_times, &output_file, i);
 		}
-		if (test_failed == false)
-			sum_time += test_stats(&test_times, &output_file, i);
+		delete world;
 	}
 
 	/* Print the duration of the test in seconds */
-	output_file << "AVG TEST TIME: " << sum_time / (NUM_TESTS - failures) << " seconds.\r\n";
-	output_file << failures << " failures out of " << NUM_TESTS << " total tests.\r\n";
-	output_file << depth_exceeded << " tests exceeded the max search depth out of " << 
-		NUM_TESTS << " total tests.\r\n";
+	for (int v = 0; v < num_variants; v++)
+	{
+		if (num_variants > 1)
+			output_file << variants[v].get_name() << ":\r\n";
+		output_file << "AVG TEST TIME: " << sum_time[v] / (options->num_tests - failures[v]) <<
+			" seconds.\r\n";
+		output_file << failures[v] << " failures out of " << options->num_tests << " total tests.\r\n";
+		output_file << depth_exceeded[v] << " tests exceeded the max search depth out of " << 
+			options->num_tests << " total tests.\r\n";
+	}
 	output_file.close();
-#endif
-
-	return 0;
 }
 
 /*
-* Deal with an exception
+* Deal with a search that stopped without a solution
 * @param failures: The number of failures that have occurred so far
 * @param depth_exceeded: The number of tests in which an agent has exceeded the max depth so far
-* @param exception_msg: The message from the exception that caused the failure
+* @param status: The reason the search stopped
 * @param output_file: The file to output results to
 * @param test_num: The number of the test being run
 */
 void catch_failure(
-	int& failures, int &depth_exceeded, std::string exception_msg, 
+	int& failures, int &depth_exceeded, SearchStatus status, 
 	std::ofstream* output_file, int test_num
 	)
 {
-	/* Special Case: Time limit exceeded exception */
-	if (exception_msg == "TIME LIMIT EXCEEDED")
+	/* Special Case: Time limit exceeded */
+	if (status == SEARCH_TIMEOUT)
 	{
 		std::cout << "Test " << test_num << " failed." << std::endl;
 		*output_file << "Test " << test_num << " failed. \r\n";
 		failures++;
 	}
-	else if (exception_msg == "Exceeded max search depth.")
+	else if (status == SEARCH_DEPTH_EXCEEDED)
 	{
 		/* An agent exceeded max search depth */
 		std::cout << "An agent in test " << test_num << 
@@ -206,7 +302,7 @@ void catch_failure(
 			" exceeded the max search depth.\r\n";
 		depth_exceeded++;
 	}
-	else if (exception_msg == "Ran out of CBS nodes.")
+	else if (status == SEARCH_INFEASIBLE)
 	{
 		std::cout << "An agent in test " << test_num << 
 			" ran out of CBS nodes to expand." << std::endl;
@@ -214,9 +310,15 @@ void catch_failure(
 			" ran out of CBS nodes to expand.\r\n";
 		failures++;
 	}
-	/* Print the error message */
+	else if (status == SEARCH_PRIORITY_FAILED)
+	{
+		std::cout << "Prioritized planning failed in test " << test_num << "." << std::endl;
+		*output_file << "Prioritized planning failed in test " << test_num << ".\r\n";
+		failures++;
+	}
+	/* Print why the search stopped */
 	else
-		std::cout << exception_msg << std::endl;
+		std::cout << CBSTree::status_message(status) << std::endl;
 }
 
 /*
@@ -256,4 +358,93 @@ double test_stats(std::vector<double>* test_times, std::ofstream* output_file, i
 		ci_high << "].\r\n";
 
 	return mean;
+}
+
+/*
+* Create the tree for the search selected by the options
+* @param world: A world already loaded from world_file, NULL to load it
+* @param agent_file: The name of the file containing each agent
+* @param world_file: The name of the file containing the world
+* @param options: The solver configuration
+* @return the new tree
+*/
+CBSTree* create_tree(
+	World* world, std::string agent_file, std::string world_file, SolverOptions* options
+	)
+{
+	switch (options->solver)
+	{
+	case SOLVER_ECBS:
+		return new ECBSTree(agent_file, world_file, options->ecbs_weight, options);
+	case SOLVER_LNS:
+		return new LNSTree(agent_file, world_file, options);
+	case SOLVER_PRIORITIZED:
+		return new PrioritizedTree(agent_file, world_file, options);
+	default:
+		break;
+	}
+
+	/* Only plain CBS shares a loaded world */
+	CBSTree* tree;
+	if (world != NULL)
+		tree = new CBSTree(world, agent_file, options);
+	else
+		tree = new CBSTree(agent_file, world_file, options);
+	if (options->warm_start)
+		tree->warm_start();
+	return tree;
+}
+
+/*
+* Print the memory high-water mark of a CBSTree's run
+* @param tree: The tree whose search has finished
+* @param out: The stream to print to
+*/
+void print_peak_memory(CBSTree* tree, std::ostream* out)
+{
+	/* Bytes in a megabyte */
+	const double MEGABYTE = 1024 * 1024;
+
+	*out << "peak memory: " << tree->get_peak_nodes() << " A* nodes (~" <<
+		tree->get_peak_bytes() / MEGABYTE << " MB).\r\n";
+}
+
+/*
+* Print the suboptimality bound achieved by an ECBS or anytime run, how often
+* adaptive CBS or LPA-CBS repaired or searched again its child agents and how many
+* states the low level searches expanded
+* @param tree: The tree whose search has finished
+* @param options: The solver configuration the tree was created with
+* @param out: The stream to print to
+*/
+void print_bound(CBSTree* tree, SolverOptions* options, std::ostream* out)
+{
+	if (options->solver == SOLVER_ECBS)
+	{
+		ECBSTree* ecbs_tree = static_cast<ECBSTree*>(tree);
+
+		*out << "achieved bound: " << ecbs_tree->get_achieved_bound() << " (lower bound " <<
+			ecbs_tree->get_lower_bound() << ", weight " << ecbs_tree->get_weight() << ").\r\n";
+	}
+	else if (options->solver == SOLVER_LNS)
+	{
+		LNSTree* lns_tree = static_cast<LNSTree*>(tree);
+
+		*out << "anytime cost: " << lns_tree->get_cost() << " (lower bound " <<
+			lns_tree->get_lower_bound() << ", " << lns_tree->get_iterations() << " neighborhoods, " <<
+			lns_tree->get_improvements() << " improvements).\r\n";
+	}
+	else if (options->solver == SOLVER_CBS && options->warm_start)
+		*out << "warm start upper bound: " << tree->get_upper_bound() << ".\r\n";
+
+	if (options->solver == SOLVER_CBS &&
+		(options->repair == REPAIR_ADAPTIVE || options->repair == REPAIR_LPA_STAR))
+		*out << "repaired agents: " << tree->get_repairs() << ", restarted agents: " <<
+			tree->get_restarts() << ".\r\n";
+	if (options->solver != SOLVER_CBS)
+		return;
+
+	if (options->repair == REPAIR_LPA_STAR)
+		*out << "peak LPA* states: " << tree->get_peak_states() << ".\r\n";
+	*out << "expanded states: " << tree->get_expansions() << ".\r\n";
 }
\ No newline at end of file